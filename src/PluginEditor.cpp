@@ -3,9 +3,9 @@
 
 //==============================================================================
 AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor(AudioPluginAudioProcessor& p)
-    : AudioProcessorEditor(&p), processor(p)
+    : AudioProcessorEditor(&p), processor(p), spectrogram(p.getSpectrumQueue())
 {
-    setSize(600, 520);
+    setSize(600, 730);
 
     // Start Recording Button
     startRecordingButton.setButtonText("Start Recording");
@@ -33,15 +33,69 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor(AudioPluginAudi
     addAndMakeVisible(stopRecordingButton);
 
     // Export Button
-    exportButton.setButtonText("Export CSV");
+    exportButton.setButtonText("Export Data");
     exportButton.setColour(juce::TextButton::buttonColourId, juce::Colour(0xff2196F3));
     exportButton.onClick = [this]()
         {
-            processor.exportToCSV();
+            chooseExportFile();
         };
     exportButton.setEnabled(false);
     addAndMakeVisible(exportButton);
 
+    // Export progress, only shown while an export is running
+    cancelExportButton.setButtonText("Cancel");
+    cancelExportButton.onClick = [this]()
+        {
+            processor.cancelExport();
+        };
+    addChildComponent(cancelExportButton);
+    addChildComponent(exportProgressBar);
+
+    // Which channel or derived view the meters show; every stream is logged regardless
+    streamSelector.onChange = [this]()
+        {
+            processor.setDisplayedStream(juce::jmax(0, streamSelector.getSelectedItemIndex()));
+        };
+    addAndMakeVisible(streamSelector);
+
+    midSideToggle.setButtonText("Mid/Side");
+    midSideToggle.setToggleState(processor.isMidSideAnalysisEnabled(), juce::dontSendNotification);
+    midSideToggle.onClick = [this]()
+        {
+            processor.setMidSideAnalysisEnabled(midSideToggle.getToggleState());
+        };
+    addAndMakeVisible(midSideToggle);
+
+    channelSumToggle.setButtonText("Channel Sum");
+    channelSumToggle.setToggleState(processor.isChannelSumAnalysisEnabled(), juce::dontSendNotification);
+    channelSumToggle.onClick = [this]()
+        {
+            processor.setChannelSumAnalysisEnabled(channelSumToggle.getToggleState());
+        };
+    addAndMakeVisible(channelSumToggle);
+
+    updateStreamSelector();
+
+    spectrogram.setSampleRate(processor.getSampleRate());
+    addAndMakeVisible(spectrogram);
+
+    // Live spectrum beside the spectrogram: hidden, unsmoothed or 1/n octave
+    spectrumSmoothingSelector.addItem("Spectrum Off", 1);
+    spectrumSmoothingSelector.addItem("Spectrum Raw", 2);
+    spectrumSmoothingSelector.addItem("1/3 Octave", 3);
+    spectrumSmoothingSelector.addItem("1/6 Octave", 4);
+    spectrumSmoothingSelector.addItem("1/12 Octave", 5);
+    spectrumSmoothingSelector.onChange = [this]()
+        {
+            const int bandsPerOctave[] = { 0, 0, 3, 6, 12 };
+            const auto index = juce::jlimit(0, 4, spectrumSmoothingSelector.getSelectedItemIndex());
+
+            spectrogram.setLiveSpectrumVisible(index > 0);
+            spectrogram.setOctaveSmoothing(bandsPerOctave[index]);
+        };
+    spectrumSmoothingSelector.setSelectedId(3);
+    addAndMakeVisible(spectrumSmoothingSelector);
+
     startTimerHz(30); // Update UI at 30 Hz
 }
 
@@ -52,42 +106,39 @@ AudioPluginAudioProcessorEditor::~AudioPluginAudioProcessorEditor()
 //==============================================================================
 void AudioPluginAudioProcessorEditor::paint(juce::Graphics& g)
 {
-    g.fillAll(juce::Colour(0xff1a1a1a));
+    // Background, titles and labels only change with size or display scale
+    const auto scale = juce::Component::getApproximateScaleFactorForComponent(this);
 
-    // Title
-    g.setColour(juce::Colours::white);
-    g.setFont(22.0f);
-    g.drawText("Acoustic Environment Research Tool", 20, 15, getWidth() - 40, 25, juce::Justification::centred);
+    if (!staticLayer.isValid() || scale != staticLayerScale
+        || staticLayer.getWidth() != juce::roundToInt(getWidth() * scale))
+        renderStaticLayer(scale);
 
-    // Version and beta label
-    g.setFont(12.0f);
-    g.setColour(juce::Colours::orange);
-    g.drawText("BETA v0.1", 20, 40, getWidth() - 40, 15, juce::Justification::centred);
+    g.drawImage(staticLayer, getLocalBounds().toFloat());
 
     // Recording status and time
-    if (processor.isCurrentlyLogging())
-    {
-        g.setFont(14.0f);
-        g.setColour(juce::Colour(0xffFF5252));
-        juce::String statusText = "RECORDING - " + formatTime(processor.getRecordingTime());
-        g.drawText(statusText, 20, 430, 200, 20, juce::Justification::left);
-
-        // Data point counter
-        g.setColour(juce::Colours::lightgrey);
-        g.setFont(12.0f);
-        juce::String pointsText = "Data points: " + juce::String(processor.getDataPointCount());
-        g.drawText(pointsText, 20, 450, 200, 20, juce::Justification::left);
-    }
-    else if (processor.getDataPointCount() > 0)
+    if (statusText.isNotEmpty())
     {
-        g.setFont(12.0f);
-        g.setColour(juce::Colour(0xff4CAF50));
-        juce::String statusText = "Ready to export (" + juce::String(processor.getDataPointCount()) + " points)";
-        g.drawText(statusText, 20, 440, 200, 20, juce::Justification::left);
+        if (processor.isCurrentlyLogging())
+        {
+            g.setFont(14.0f);
+            g.setColour(juce::Colour(0xffFF5252));
+            g.drawText(statusText, 20, 430, 200, 20, juce::Justification::left);
+
+            // Data point counter
+            g.setColour(juce::Colours::lightgrey);
+            g.setFont(12.0f);
+            g.drawText(pointsText, 20, 450, 200, 20, juce::Justification::left);
+        }
+        else
+        {
+            g.setFont(12.0f);
+            g.setColour(juce::Colour(0xff4CAF50));
+            g.drawText(statusText, 20, 440, 200, 20, juce::Justification::left);
+        }
     }
 
     // Acoustic Activation Score (main display)
-    float score = processor.getAcousticActivationScore();
+    float score = displayedFeatures.acousticActivationScore;
     juce::Colour scoreColour = getScoreColour(score);
 
     g.setColour(scoreColour);
@@ -95,30 +146,66 @@ void AudioPluginAudioProcessorEditor::paint(juce::Graphics& g)
     juce::String scoreText = juce::String(score, 1);
     g.drawText(scoreText, 20, 70, getWidth() - 40, 60, juce::Justification::centred);
 
-    g.setFont(16.0f);
-    g.setColour(juce::Colours::lightgrey);
-    g.drawText("Acoustic Activation Index (0-100)", 20, 130, getWidth() - 40, 20, juce::Justification::centred);
-
     // Interpretation text
     g.setFont(14.0f);
     g.setColour(scoreColour);
     g.drawText(getInterpretationText(score), 20, 150, getWidth() - 40, 20, juce::Justification::centred);
 
+    // BS.1770 loudness of all input channels
+    g.setFont(12.0f);
+    g.setColour(juce::Colours::lightgrey);
+    g.drawText(loudnessText, 20, 170, getWidth() - 40, 16, juce::Justification::centred);
+
+    // Time-weighted levels of the displayed stream, under the spectrogram
+    g.drawText(soundLevelText, 20, 672, getWidth() - 40, 16, juce::Justification::centred);
+
+    // Session percentiles of the displayed stream since recording started
+    g.drawText(percentileText, 20, 688, getWidth() - 40, 16, juce::Justification::centred);
+
     // Individual metrics
-    int yPos = 190;
-    int barHeight = 30;
-    int spacing = 50;
+    const auto values = getMetricValues(displayedFeatures);
 
-    drawMetricBar(g, "Spectral Brightness", processor.getSpectralCentroid(), yPos);
-    yPos += spacing;
+    for (int i = 0; i < numMetrics; ++i)
+        drawMetricValue(g, values[(size_t)i], getMetricY(i));
+}
 
-    drawMetricBar(g, "Spectral Harshness", processor.getSpectralHarshness(), yPos);
-    yPos += spacing;
+void AudioPluginAudioProcessorEditor::renderStaticLayer(float scale)
+{
+    staticLayerScale = scale;
+    staticLayer = juce::Image(juce::Image::ARGB,
+                              juce::jmax(1, juce::roundToInt(getWidth() * scale)),
+                              juce::jmax(1, juce::roundToInt(getHeight() * scale)),
+                              true);
 
-    drawMetricBar(g, "Dynamic Variability", processor.getDynamicVariability(), yPos);
-    yPos += spacing;
+    juce::Graphics g(staticLayer);
+    g.addTransform(juce::AffineTransform::scale(scale));
 
-    drawMetricBar(g, "Temporal Unpredictability", processor.getTemporalUnpredictability(), yPos);
+    g.fillAll(juce::Colour(0xff1a1a1a));
+
+    // Title
+    g.setColour(juce::Colours::white);
+    g.setFont(22.0f);
+    g.drawText("Acoustic Environment Research Tool", 20, 15, getWidth() - 40, 25, juce::Justification::centred);
+
+    // Version and beta label
+    g.setFont(12.0f);
+    g.setColour(juce::Colours::orange);
+    g.drawText("BETA v0.1", 20, 40, getWidth() - 40, 15, juce::Justification::centred);
+
+    g.setFont(16.0f);
+    g.setColour(juce::Colours::lightgrey);
+    g.drawText("Acoustic Activation Index (0-100)", 20, 130, getWidth() - 40, 20, juce::Justification::centred);
+
+    // Metric labels and empty bars
+    const char* const labels[numMetrics] = { "Spectral Brightness", "Spectral Harshness",
+                                             "Dynamic Variability", "Temporal Unpredictability" };
+
+    for (int i = 0; i < numMetrics; ++i)
+        drawMetricBackground(g, labels[i], getMetricY(i));
+
+    g.setColour(juce::Colours::white);
+    g.setFont(14.0f);
+    g.drawText("Stream", 20, 370, 60, 22, juce::Justification::left);
 
     // Disclaimer at bottom
     g.setFont(10.0f);
@@ -141,12 +228,262 @@ void AudioPluginAudioProcessorEditor::resized()
     startRecordingButton.setBounds(startX, buttonY, buttonWidth, buttonHeight);
     stopRecordingButton.setBounds(startX + buttonWidth + spacing, buttonY, buttonWidth, buttonHeight);
     exportButton.setBounds(startX + (buttonWidth + spacing) * 2, buttonY, buttonWidth, buttonHeight);
+
+    streamSelector.setBounds(80, 370, 120, 22);
+    midSideToggle.setBounds(215, 370, 100, 22);
+    channelSumToggle.setBounds(320, 370, 120, 22);
+    spectrumSmoothingSelector.setBounds(450, 370, 130, 22);
+
+    spectrogram.setBounds(20, 480, getWidth() - 40, 185);
+
+    // Export progress sits to the right of the recording status
+    exportProgressBar.setBounds(230, 440, 250, 20);
+    cancelExportButton.setBounds(490, 440, 90, 20);
+
+    staticLayer = {};
 }
 
 //==============================================================================
 void AudioPluginAudioProcessorEditor::timerCallback()
 {
-    repaint();
+    updateExportStatus();
+    updateStreamSelector();
+    updateStatusText();
+
+    // Columns are added from the queue; the spectrogram repaints only itself
+    spectrogram.setSampleRate(processor.getSampleRate());
+    spectrogram.update();
+
+    // Nothing to do until the analysis thread publishes a new frame
+    const auto version = processor.getFeatureVersion();
+
+    if (version != lastFeatureVersion)
+    {
+        lastFeatureVersion = version;
+        updateDisplayedFeatures(processor.getFeatureSnapshot().frame);
+    }
+}
+
+void AudioPluginAudioProcessorEditor::updateDisplayedFeatures(const AnalysisFrame& features)
+{
+    // Repaint only the regions whose pixels would actually change
+    const auto oldScore = displayedFeatures.acousticActivationScore;
+    const auto newScore = features.acousticActivationScore;
+
+    if (juce::String(oldScore, 1) != juce::String(newScore, 1)
+        || getInterpretationText(oldScore) != getInterpretationText(newScore))
+        repaint(20, 70, getWidth() - 40, 100);
+
+    const auto oldValues = getMetricValues(displayedFeatures);
+    const auto newValues = getMetricValues(features);
+    const auto barWidth = getWidth() - metricBarX - 50;
+
+    for (int i = 0; i < numMetrics; ++i)
+    {
+        const auto oldValue = oldValues[(size_t)i];
+        const auto newValue = newValues[(size_t)i];
+
+        if (static_cast<int>(barWidth * oldValue) != static_cast<int>(barWidth * newValue)
+            || juce::String(oldValue * 100.0f, 0) != juce::String(newValue * 100.0f, 0))
+            repaint(metricBarX, getMetricY(i), getWidth() - metricBarX, metricBarHeight);
+    }
+
+    const auto newLoudnessText = getLoudnessText(features);
+
+    if (newLoudnessText != loudnessText)
+    {
+        loudnessText = newLoudnessText;
+        repaint(20, 170, getWidth() - 40, 16);
+    }
+
+    const auto newSoundLevelText = getSoundLevelText(features);
+
+    if (newSoundLevelText != soundLevelText)
+    {
+        soundLevelText = newSoundLevelText;
+        repaint(20, 672, getWidth() - 40, 16);
+    }
+
+    const auto newPercentileText = getPercentileText(features);
+
+    if (newPercentileText != percentileText)
+    {
+        percentileText = newPercentileText;
+        repaint(20, 688, getWidth() - 40, 16);
+    }
+
+    displayedFeatures = features;
+}
+
+void AudioPluginAudioProcessorEditor::updateStatusText()
+{
+    juce::String newStatus, newPoints;
+
+    if (processor.isCurrentlyLogging())
+    {
+        newStatus = "RECORDING - " + formatTime(processor.getRecordingTime());
+        newPoints = "Data points: " + juce::String(processor.getDataPointCount());
+    }
+    else if (processor.getDataPointCount() > 0)
+    {
+        newStatus = "Ready to export (" + juce::String(processor.getDataPointCount()) + " points)";
+    }
+
+    if (newStatus != statusText || newPoints != pointsText)
+    {
+        statusText = newStatus;
+        pointsText = newPoints;
+        repaint(20, 430, 200, 40);
+    }
+}
+
+std::array<float, AudioPluginAudioProcessorEditor::numMetrics> AudioPluginAudioProcessorEditor::getMetricValues(const AnalysisFrame& features)
+{
+    return { features.spectralCentroid, features.spectralHarshness,
+             features.dynamicVariability, features.temporalUnpredictability };
+}
+
+juce::String AudioPluginAudioProcessorEditor::getLoudnessText(const AnalysisFrame& features)
+{
+    auto lufs = [](float value)
+        {
+            return value <= LoudnessMeter::minimumLoudness ? juce::String("-inf") : juce::String(value, 1);
+        };
+
+    return "M " + lufs(features.momentaryLoudness)
+         + "   S " + lufs(features.shortTermLoudness)
+         + "   I " + lufs(features.integratedLoudness) + " LUFS"
+         + "   LRA " + juce::String(features.loudnessRange, 1) + " LU";
+}
+
+juce::String AudioPluginAudioProcessorEditor::getSoundLevelText(const AnalysisFrame& features)
+{
+    auto level = [](float value)
+        {
+            return value <= SoundLevelMeter::minimumLevel ? juce::String("-inf") : juce::String(value, 1);
+        };
+
+    const auto fast = (size_t)TimeWeighting::Mode::fast;
+    const auto slow = (size_t)TimeWeighting::Mode::slow;
+    const auto impulse = (size_t)TimeWeighting::Mode::impulse;
+
+    return "LAF " + level(features.aWeightedLevels[fast])
+         + "   LAS " + level(features.aWeightedLevels[slow])
+         + "   LAI " + level(features.aWeightedLevels[impulse])
+         + "   LAFmax " + level(features.aWeightedMaxLevels[fast])
+         + "   LCpeak " + level(features.cWeightedPeak) + " dB";
+}
+
+juce::String AudioPluginAudioProcessorEditor::getPercentileText(const AnalysisFrame& features)
+{
+    using Feature = SessionStatistics::Feature;
+
+    const auto& levels = features.sessionPercentiles[(size_t)Feature::level];
+    const auto& scores = features.sessionPercentiles[(size_t)Feature::activationScore];
+    juce::String text;
+
+    for (int p = 0; p < SessionStatistics::numPercentiles; ++p)
+    {
+        const auto level = levels[(size_t)p];
+        text << "LA" << juce::String(SessionStatistics::percentages[(size_t)p], 0) << " "
+             << (level <= SoundLevelMeter::minimumLevel ? juce::String("-inf") : juce::String(level, 1)) << "   ";
+    }
+
+    return text + "dB   Score L10/L50/L90 " + juce::String(scores[0], 0) + " / " + juce::String(scores[1], 0) + " / " + juce::String(scores[2], 0);
+}
+
+void AudioPluginAudioProcessorEditor::updateStreamSelector()
+{
+    // The stream list changes with the bus layout and the mid/side and sum options
+    auto names = processor.getAnalysisStreamNames();
+
+    if (names == streamNames)
+        return;
+
+    streamNames = names;
+    streamSelector.clear(juce::dontSendNotification);
+    streamSelector.addItemList(streamNames, 1);
+
+    const auto displayed = juce::jlimit(0, juce::jmax(0, streamNames.size() - 1), processor.getDisplayedStream());
+    streamSelector.setSelectedItemIndex(displayed, juce::dontSendNotification);
+    processor.setDisplayedStream(displayed);
+}
+
+void AudioPluginAudioProcessorEditor::chooseExportFile()
+{
+    if (processor.getDataPointCount() == 0)
+    {
+        juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
+            "No Data",
+            "No data to export. Please record data first.",
+            "OK");
+        return;
+    }
+
+    fileChooser = std::make_unique<juce::FileChooser>(
+        "Save Data (.csv, or .aas for a binary session)",
+        juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("acoustic_data.csv"),
+        "*.csv;*.aas");
+
+    auto flags = juce::FileBrowserComponent::saveMode
+        | juce::FileBrowserComponent::canSelectFiles
+        | juce::FileBrowserComponent::warnAboutOverwriting;
+
+    // The chooser is owned by the editor, so the callback can't outlive it
+    fileChooser->launchAsync(flags, [this](const juce::FileChooser& fc)
+        {
+            auto outputFile = fc.getURLResult().getLocalFile();
+
+            if (outputFile == juce::File{})
+                return;
+
+            // Rows are written on a background thread; timerCallback() picks up the result
+            if (processor.exportSession(outputFile))
+                updateExportStatus();
+        });
+}
+
+void AudioPluginAudioProcessorEditor::updateExportStatus()
+{
+    const auto& exporter = processor.getSessionExporter();
+    const auto isExporting = exporter.isRunning();
+
+    exportProgress = exporter.getProgress();
+    exportProgressBar.setVisible(isExporting);
+    cancelExportButton.setVisible(isExporting);
+
+    if (isExporting)
+        exportButton.setEnabled(false);
+
+    if (wasExporting && !isExporting)
+    {
+        exportButton.setEnabled(!processor.isCurrentlyLogging());
+
+        switch (exporter.getState())
+        {
+            case SessionExporter::State::succeeded:
+                juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::InfoIcon,
+                    "Export Successful",
+                    "Data exported to:\n" + exporter.getDestination().getFullPathName() +
+                    "\n\nTotal data points: " + juce::String(exporter.getNumRows()),
+                    "OK");
+                break;
+
+            case SessionExporter::State::failed:
+                juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
+                    "Export Failed",
+                    exporter.getErrorMessage(),
+                    "OK");
+                break;
+
+            case SessionExporter::State::cancelled:
+            case SessionExporter::State::idle:
+            case SessionExporter::State::running:
+                break;
+        }
+    }
+
+    wasExporting = isExporting;
 }
 
 juce::Colour AudioPluginAudioProcessorEditor::getScoreColour(float score)
@@ -175,29 +512,32 @@ juce::String AudioPluginAudioProcessorEditor::formatTime(double seconds)
     return juce::String::formatted("%02d:%02d.%01d", mins, secs, millis);
 }
 
-void AudioPluginAudioProcessorEditor::drawMetricBar(juce::Graphics& g, const juce::String& label, float value, int y)
+void AudioPluginAudioProcessorEditor::drawMetricBackground(juce::Graphics& g, const juce::String& label, int y)
 {
-    int barX = 190;
-    int barWidth = getWidth() - barX - 50;
-    int barHeight = 20;
+    int barWidth = getWidth() - metricBarX - 50;
 
     // Label
     g.setColour(juce::Colours::white);
     g.setFont(14.0f);
-    g.drawText(label, 20, y, 160, barHeight, juce::Justification::left);
+    g.drawText(label, 20, y, 160, metricBarHeight, juce::Justification::left);
 
     // Background bar
     g.setColour(juce::Colour(0xff333333));
-    g.fillRect(barX, y, barWidth, barHeight);
+    g.fillRect(metricBarX, y, barWidth, metricBarHeight);
+}
+
+void AudioPluginAudioProcessorEditor::drawMetricValue(juce::Graphics& g, float value, int y)
+{
+    int barWidth = getWidth() - metricBarX - 50;
 
     // Value bar
     juce::Colour barColour = juce::Colour(0xff2196F3);
     g.setColour(barColour);
-    g.fillRect(barX, y, static_cast<int>(barWidth * value), barHeight);
+    g.fillRect(metricBarX, y, static_cast<int>(barWidth * value), metricBarHeight);
 
     // Value text
     g.setColour(juce::Colours::white);
     g.setFont(12.0f);
     juce::String valueText = juce::String(value * 100.0f, 0) + "%";
-    g.drawText(valueText, barX + barWidth + 10, y, 50, barHeight, juce::Justification::left);
-}
\ No newline at end of file
+    g.drawText(valueText, metricBarX + barWidth + 10, y, 50, metricBarHeight, juce::Justification::left);
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "PluginProcessor.h"
+#include "SpectrogramComponent.h"
 
 //==============================================================================
 class AudioPluginAudioProcessorEditor : public juce::AudioProcessorEditor,
@@ -16,16 +17,59 @@ public:
 private:
     void timerCallback() override;
     juce::Colour getScoreColour(float score);
-    void drawMetricBar(juce::Graphics& g, const juce::String& label, float value, int y);
+    void renderStaticLayer(float scale);
+    void drawMetricBackground(juce::Graphics& g, const juce::String& label, int y);
+    void drawMetricValue(juce::Graphics& g, float value, int y);
+    void updateDisplayedFeatures(const AnalysisFrame& features);
+    void updateStatusText();
     juce::String getInterpretationText(float score);
     juce::String formatTime(double seconds);
+    static juce::String getLoudnessText(const AnalysisFrame& features);
+    static juce::String getSoundLevelText(const AnalysisFrame& features);
+    static juce::String getPercentileText(const AnalysisFrame& features);
+    void chooseExportFile();
+    void updateExportStatus();
+    void updateStreamSelector();
+
+    // Metric bars: one row per metric, starting below the score
+    static constexpr int numMetrics = 4;
+    static constexpr int metricBarX = 190;
+    static constexpr int metricBarHeight = 20;
+    static int getMetricY(int index) { return 190 + index * 50; }
+    static std::array<float, numMetrics> getMetricValues(const AnalysisFrame& features);
 
     AudioPluginAudioProcessor& processor;
 
+    // Background, titles and labels, re-rendered only on resize or a display scale change
+    juce::Image staticLayer;
+    float staticLayerScale = 1.0f;
+
+    // What's currently on screen; timerCallback() repaints only the parts that differ
+    AnalysisFrame displayedFeatures;
+    juce::uint64 lastFeatureVersion = 0;
+    juce::String statusText, pointsText, loudnessText, soundLevelText, percentileText;
+
     // UI Components
     juce::TextButton startRecordingButton;
     juce::TextButton stopRecordingButton;
     juce::TextButton exportButton;
+    juce::TextButton cancelExportButton;
+
+    // Analysis stream selection
+    juce::ComboBox streamSelector;
+    juce::ToggleButton midSideToggle;
+    juce::ToggleButton channelSumToggle;
+    juce::StringArray streamNames;
+
+    // Spectrogram with live spectrum
+    SpectrogramComponent spectrogram;
+    juce::ComboBox spectrumSmoothingSelector;
+
+    // Export progress
+    double exportProgress = 0.0;
+    juce::ProgressBar exportProgressBar{ exportProgress };
+    std::unique_ptr<juce::FileChooser> fileChooser;
+    bool wasExporting = false;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioPluginAudioProcessorEditor)
 };
\ No newline at end of file
@@ -5,192 +5,193 @@
 AudioPluginAudioProcessor::AudioPluginAudioProcessor()
     : AudioProcessor(BusesProperties()
         .withInput("Input", juce::AudioChannelSet::stereo(), true)
-        .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
-    fft(fftOrder),
-    window(fftSize, juce::dsp::WindowingFunction<float>::hann)
+        .withOutput("Output", juce::AudioChannelSet::stereo(), true))
 {
-    fftData.fill(0.0f);
-    rmsHistory.fill(0.0f);
+    updateRequestedHopSize();
 }
 
 AudioPluginAudioProcessor::~AudioPluginAudioProcessor() {}
 
 void AudioPluginAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
+    analysisWorker.release();
+
     currentSampleRate = sampleRate;
-    fftPos = 0;
-}
+    updateRequestedHopSize();
 
-void AudioPluginAudioProcessor::releaseResources() {}
+    const auto numChannels = juce::jmax(1, getTotalNumInputChannels());
+    const auto inputLayout = getChannelLayoutOfBus(true, 0);
 
-bool AudioPluginAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
-{
-    return layouts.getMainOutputChannelSet() == layouts.getMainInputChannelSet()
-        && !layouts.getMainInputChannelSet().isDisabled();
+    loudnessWeights.clear();
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        loudnessWeights.push_back(LoudnessMeter::getChannelWeight(inputLayout.getTypeOfChannel(ch)));
+
+    prepareEngine(numChannels);
+    samplesAnalysed = 0;
+    engineStartSample = 0;
+    sessionClock.prepare(sampleRate);
+
+    // Half a second of headroom in case the analysis thread gets descheduled
+    analysisWorker.prepare(numChannels, juce::jmax(fftSize * 4, samplesPerBlock * 4, static_cast<int>(sampleRate * 0.5)));
 }
 
-void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+void AudioPluginAudioProcessor::prepareEngine(int numChannels)
 {
-    auto totalNumInputChannels = getTotalNumInputChannels();
-    auto totalNumOutputChannels = getTotalNumOutputChannels();
+    MultichannelAnalysisEngine::Options options;
+    options.includeMidSide = requestedMidSide.load();
+    options.includeSum = requestedSum.load();
+    options.fullScaleLevel = requestedFullScaleLevel.load();
 
-    // Clear unused output channels
-    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear(i, 0, buffer.getNumSamples());
+    engine.setHopSize(requestedHopSize.load());
+    engine.prepare(currentSampleRate, numChannels, options);
 
-    // Calculate RMS
-    float rms = buffer.getRMSLevel(0, 0, buffer.getNumSamples());
-    rmsLevel.store(rms);
+    for (size_t ch = 0; ch < loudnessWeights.size(); ++ch)
+        engine.setLoudnessChannelWeight(static_cast<int>(ch), loudnessWeights[ch]);
 
-    // Store RMS in history
-    rmsHistory[rmsHistoryPos] = rms;
-    rmsHistoryPos = (rmsHistoryPos + 1) % rmsHistorySize;
+    juce::StringArray names;
 
-    // Collect samples for FFT (using first channel)
-    auto* channelData = buffer.getReadPointer(0);
-    for (int i = 0; i < buffer.getNumSamples(); ++i)
-    {
-        fftData[fftPos] = channelData[i];
-        fftPos++;
+    for (int i = 0; i < engine.getNumStreams(); ++i)
+        names.add(engine.getStreamName(i));
 
-        if (fftPos >= fftSize)
-        {
-            fftPos = 0;
-            performFFTAnalysis();
-        }
-    }
+    const juce::ScopedLock sl(streamNamesLock);
+    streamNames = names;
 }
 
-void AudioPluginAudioProcessor::performFFTAnalysis()
+juce::StringArray AudioPluginAudioProcessor::getAnalysisStreamNames() const
 {
-    // Apply windowing
-    window.multiplyWithWindowingTable(fftData.data(), fftSize);
+    const juce::ScopedLock sl(streamNamesLock);
+    return streamNames;
+}
 
-    // Perform FFT
-    fft.performFrequencyOnlyForwardTransform(fftData.data());
+void AudioPluginAudioProcessor::releaseResources()
+{
+    analysisWorker.release();
+}
 
-    // Calculate metrics
-    calculateSpectralCentroid();
-    calculateSpectralHarshness();
-    calculateDynamicVariability();
-    calculateTemporalUnpredictability();
-    calculateAcousticActivationScore();
+void AudioPluginAudioProcessor::setAnalysisFrameRate(double framesPerSecond)
+{
+    analysisFrameRate = framesPerSecond;
+    updateRequestedHopSize();
+}
 
-    // Log data if recording
-    if (isLogging.load())
-    {
-        logDataPoint();
-    }
+void AudioPluginAudioProcessor::setAnalysisOverlap(STFTProcessor::Overlap overlap)
+{
+    analysisFrameRate = 0.0;
+    analysisOverlap = overlap;
+    updateRequestedHopSize();
 }
 
-void AudioPluginAudioProcessor::calculateSpectralCentroid()
+void AudioPluginAudioProcessor::updateRequestedHopSize()
 {
-    float numerator = 0.0f;
-    float denominator = 0.0f;
+    requestedHopSize.store(analysisFrameRate > 0.0
+        ? STFTProcessor::getHopSizeForFrameRate(fftSize, currentSampleRate, analysisFrameRate)
+        : STFTProcessor::getHopSizeForOverlap(fftSize, analysisOverlap));
+}
 
-    for (int i = 0; i < fftSize / 2; ++i)
-    {
-        float magnitude = fftData[i];
-        float frequency = (i * currentSampleRate) / fftSize;
+bool AudioPluginAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+    return layouts.getMainOutputChannelSet() == layouts.getMainInputChannelSet()
+        && !layouts.getMainInputChannelSet().isDisabled();
+}
 
-        numerator += magnitude * frequency;
-        denominator += magnitude;
-    }
+void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+{
+    auto totalNumInputChannels = getTotalNumInputChannels();
+    auto totalNumOutputChannels = getTotalNumOutputChannels();
+
+    // Clear unused output channels
+    for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
+        buffer.clear(i, 0, buffer.getNumSamples());
 
-    float centroid = denominator > 0.0f ? numerator / denominator : 0.0f;
+    // Host timeline position, only while the transport is running
+    juce::Optional<juce::int64> hostPosition;
 
-    // Normalize to 0-1 range (assuming 0-8000 Hz is relevant range)
-    spectralCentroid.store(juce::jlimit(0.0f, 1.0f, centroid / 8000.0f));
+    if (auto* playHead = getPlayHead())
+        if (auto position = playHead->getPosition())
+            if (position->getIsPlaying())
+                hostPosition = position->getTimeInSamples();
+
+    // Count the block before the analysis thread can see it, so any timeline anchor is already queued
+    sessionClock.advance(buffer.getNumSamples(), hostPosition.hasValue(), hostPosition.orFallback(0));
+
+    // Hand every input channel to the analysis thread; nothing else happens here
+    analysisWorker.push(buffer.getArrayOfReadPointers(), totalNumInputChannels, buffer.getNumSamples());
 }
 
-void AudioPluginAudioProcessor::calculateSpectralHarshness()
+void AudioPluginAudioProcessor::analyseSamples(const float* const* channels, int numChannels, int numSamples)
 {
-    // Harshness correlates with high-frequency energy (>2kHz) and roughness
-    // Simple metric: ratio of high-freq energy to total energy
+    // Pick up resolution and stream layout changes from the message thread
+    auto hopSize = requestedHopSize.load(std::memory_order_relaxed);
+    if (hopSize != engine.getHopSize())
+        engine.setHopSize(hopSize);
 
-    float lowFreqEnergy = 0.0f;
-    float highFreqEnergy = 0.0f;
-    int crossoverBin = static_cast<int>((2000.0 * fftSize) / currentSampleRate);
-
-    for (int i = 0; i < fftSize / 2; ++i)
+    const auto options = engine.getOptions();
+    if (options.includeMidSide != requestedMidSide.load(std::memory_order_relaxed)
+        || options.includeSum != requestedSum.load(std::memory_order_relaxed))
     {
-        float magnitude = fftData[i];
-        if (i < crossoverBin)
-            lowFreqEnergy += magnitude;
-        else
-            highFreqEnergy += magnitude;
+        prepareEngine(numChannels);
+        engineStartSample = samplesAnalysed;
     }
 
-    float totalEnergy = lowFreqEnergy + highFreqEnergy;
-    float harshness = totalEnergy > 0.0f ? highFreqEnergy / totalEnergy : 0.0f;
-
-    spectralHarshness.store(juce::jlimit(0.0f, 1.0f, harshness * 2.0f)); // Scale up for visibility
-}
+    const auto fullScaleLevel = requestedFullScaleLevel.load(std::memory_order_relaxed);
+    if (options.fullScaleLevel != fullScaleLevel)
+        engine.setFullScaleLevel(fullScaleLevel);
 
-void AudioPluginAudioProcessor::calculateDynamicVariability()
-{
-    // Calculate standard deviation of RMS history
-    float mean = 0.0f;
-    for (int i = 0; i < rmsHistorySize; ++i)
-        mean += rmsHistory[i];
-    mean /= rmsHistorySize;
-
-    float variance = 0.0f;
-    for (int i = 0; i < rmsHistorySize; ++i)
+    // Integrated loudness, loudness range, Leqs, maxima and percentiles cover the recording, not everything since playback started
+    if (integrationResetRequested.exchange(false))
     {
-        float diff = rmsHistory[i] - mean;
-        variance += diff * diff;
+        engine.resetLoudnessIntegration();
+        engine.resetSession();
     }
-    variance /= rmsHistorySize;
 
-    float stdDev = std::sqrt(variance);
+    engine.setSpectrumStream(displayedStream.load(std::memory_order_relaxed));
 
-    // Normalize (arbitrary scaling based on typical values)
-    dynamicVariability.store(juce::jlimit(0.0f, 1.0f, stdDev * 20.0f));
-}
+    engine.process(channels, numChannels, numSamples, [this](const AnalysisFrame* frames, int numStreams, const float* spectrum)
+        {
+            const auto displayed = juce::jlimit(0, numStreams - 1, displayedStream.load(std::memory_order_relaxed));
+            publishFrame(frames[displayed], displayed, numStreams);
 
-void AudioPluginAudioProcessor::calculateTemporalUnpredictability()
-{
-    // Simple metric: how much consecutive RMS values differ
-    float totalDiff = 0.0f;
-    int count = 0;
+            // Dropped if the editor is closed or falling behind
+            spectrumQueue.push(spectrum);
 
-    for (int i = 1; i < rmsHistorySize; ++i)
-    {
-        totalDiff += std::abs(rmsHistory[i] - rmsHistory[i - 1]);
-        count++;
-    }
+            // Every stream shares the hop, so one timestamp covers the whole set
+            const auto centre = engineStartSample + frames[0].centreSample;
+            const auto timestamp = sessionClock.getTimestamp(centre);
 
-    float avgDiff = count > 0 ? totalDiff / count : 0.0f;
+            // Log every stream if recording, skipping windows centred before the session started
+            if (isLogging.load() && centre >= sessionClock.getSessionStartSample())
+                for (int stream = 0; stream < numStreams; ++stream)
+                    logDataPoint(frames[stream], stream, timestamp);
+        });
 
-    // Normalize
-    temporalUnpredictability.store(juce::jlimit(0.0f, 1.0f, avgDiff * 50.0f));
+    samplesAnalysed += numSamples;
 }
 
-void AudioPluginAudioProcessor::calculateAcousticActivationScore()
+void AudioPluginAudioProcessor::skipDroppedSamples(int numSamples)
 {
-    // Composite score: lower values for stress-inducing features
-    // Research-based weights (these are initial estimates - refine with your research!)
-
-    float centroidScore = (1.0f - spectralCentroid.load()) * 100.0f; // Lower centroid = calmer
-    float harshnessScore = (1.0f - spectralHarshness.load()) * 100.0f; // Lower harshness = better
-    float dynamicScore = (1.0f - dynamicVariability.load()) * 100.0f; // Lower variability = calmer
-    float unpredictScore = (1.0f - temporalUnpredictability.load()) * 100.0f; // More predictable = calmer
+    // The clock counted these samples but the engine never saw them; without the skip every
+    // later frame would be timestamped that much too early
+    samplesAnalysed += numSamples;
+    engineStartSample += numSamples;
+}
 
-    // Weighted average (adjust weights based on your research)
-    float score = (centroidScore * 0.25f +
-        harshnessScore * 0.35f +
-        dynamicScore * 0.20f +
-        unpredictScore * 0.20f);
+void AudioPluginAudioProcessor::publishFrame(const AnalysisFrame& frame, int stream, int numStreams)
+{
+    FeatureSnapshot snapshot;
+    snapshot.frame = frame;
+    snapshot.stream = stream;
+    snapshot.numStreams = numStreams;
 
-    acousticActivationScore.store(juce::jlimit(0.0f, 100.0f, score));
+    latestFeatures.store(snapshot);
 }
 
 void AudioPluginAudioProcessor::startLogging()
 {
-    juce::ScopedLock lock(dataLogLock);
-    dataLog.clear();
-    loggingStartTime = juce::Time::currentTimeMillis();
+    dataLogger.clear();
+    sessionClock.startSession();
+    dataLogger.setSessionStartTime(sessionClock.getSessionStartTime());
+    integrationResetRequested.store(true);
     isLogging.store(true);
 }
 
@@ -199,22 +200,10 @@ void AudioPluginAudioProcessor::stopLogging()
     isLogging.store(false);
 }
 
-void AudioPluginAudioProcessor::logDataPoint()
+void AudioPluginAudioProcessor::logDataPoint(const AnalysisFrame& frame, int stream, const SessionClock::Timestamp& timestamp)
 {
-    juce::ScopedLock lock(dataLogLock);
-
-    double currentTime = (juce::Time::currentTimeMillis() - loggingStartTime) / 1000.0;
-
-    DataPoint point;
-    point.timestamp = currentTime;
-    point.activationScore = acousticActivationScore.load();
-    point.spectralCentroid = spectralCentroid.load();
-    point.spectralHarshness = spectralHarshness.load();
-    point.dynamicVariability = dynamicVariability.load();
-    point.temporalUnpredictability = temporalUnpredictability.load();
-    point.rmsLevel = rmsLevel.load();
-
-    dataLog.push_back(point);
+    const auto hostTime = timestamp.hasHostTime ? timestamp.hostSeconds : std::numeric_limits<double>::quiet_NaN();
+    dataLogger.push(DataPoint::fromFrame(frame, stream, timestamp.sessionSeconds, hostTime));
 }
 
 double AudioPluginAudioProcessor::getRecordingTime() const
@@ -222,73 +211,15 @@ double AudioPluginAudioProcessor::getRecordingTime() const
     if (!isLogging.load())
         return 0.0;
 
-    return (juce::Time::currentTimeMillis() - loggingStartTime) / 1000.0;
+    return sessionClock.getSessionSeconds();
 }
 
-void AudioPluginAudioProcessor::exportToCSV()
+bool AudioPluginAudioProcessor::exportSession(const juce::File& destination)
 {
-    juce::ScopedLock lock(dataLogLock);
-
-    if (dataLog.empty())
-    {
-        juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
-            "No Data",
-            "No data to export. Please record data first.",
-            "OK");
-        return;
-    }
-
-    // Create CSV content first (before the async callback)
-    juce::String csvContent = "Timestamp_Seconds,Activation_Score,Spectral_Centroid,Spectral_Harshness,Dynamic_Variability,Temporal_Unpredictability,RMS_Level\n";
-
-    for (const auto& point : dataLog)
-    {
-        csvContent += juce::String(point.timestamp, 3) + ",";
-        csvContent += juce::String(point.activationScore, 2) + ",";
-        csvContent += juce::String(point.spectralCentroid, 4) + ",";
-        csvContent += juce::String(point.spectralHarshness, 4) + ",";
-        csvContent += juce::String(point.dynamicVariability, 4) + ",";
-        csvContent += juce::String(point.temporalUnpredictability, 4) + ",";
-        csvContent += juce::String(point.rmsLevel, 6) + "\n";
-    }
-
-    int totalPoints = static_cast<int>(dataLog.size());
-
-    // Create file chooser on the heap (it will manage its own lifetime)
-    auto chooser = std::make_shared<juce::FileChooser>(
-        "Save CSV File",
-        juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("acoustic_data.csv"),
-        "*.csv");
-
-    auto flags = juce::FileBrowserComponent::saveMode
-        | juce::FileBrowserComponent::canSelectFiles
-        | juce::FileBrowserComponent::warnAboutOverwriting;
-
-    chooser->launchAsync(flags, [csvContent, totalPoints, chooser](const juce::FileChooser& fc)
-        {
-            auto result = fc.getURLResult();
-            auto outputFile = result.getLocalFile();
-
-            if (outputFile != juce::File{})
-            {
-                // Write to file
-                if (outputFile.replaceWithText(csvContent))
-                {
-                    juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::InfoIcon,
-                        "Export Successful",
-                        "Data exported to:\n" + outputFile.getFullPathName() +
-                        "\n\nTotal data points: " + juce::String(totalPoints),
-                        "OK");
-                }
-                else
-                {
-                    juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon,
-                        "Export Failed",
-                        "Failed to write file. Check permissions.",
-                        "OK");
-                }
-            }
-        });
+    // Only the chunk pointers are copied; rows are formatted and written on the exporter's thread
+    dataLogger.flush();
+    return sessionExporter.start(dataLogger.createSnapshot(), destination,
+        SessionExporter::getFormatForFile(destination));
 }
 
 juce::AudioProcessorEditor* AudioPluginAudioProcessor::createEditor()
@@ -2,7 +2,13 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
-#include <vector>
+#include "MultichannelAnalysisEngine.h"
+#include "AnalysisWorker.h"
+#include "SessionExporter.h"
+#include "DataLogger.h"
+#include "SessionClock.h"
+#include "SeqLock.h"
+#include "SpectrumQueue.h"
 
 //==============================================================================
 class AudioPluginAudioProcessor : public juce::AudioProcessor
@@ -34,72 +40,109 @@ public:
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
-    // Analysis getters
-    float getSpectralCentroid() const { return spectralCentroid.load(); }
-    float getSpectralHarshness() const { return spectralHarshness.load(); }
-    float getRMSLevel() const { return rmsLevel.load(); }
-    float getDynamicVariability() const { return dynamicVariability.load(); }
-    float getTemporalUnpredictability() const { return temporalUnpredictability.load(); }
-    float getAcousticActivationScore() const { return acousticActivationScore.load(); }
+    // Latest features of the displayed stream, all from the same frame. Lock-free and
+    // cheap enough to call from paint(); the version changes whenever a new frame lands.
+    FeatureSnapshot getFeatureSnapshot() const { return latestFeatures.load(); }
+    juce::uint64 getFeatureVersion() const { return latestFeatures.getVersion(); }
+
+    // Magnitude spectra of the displayed stream, one per frame, for the spectrogram
+    SpectrumQueue& getSpectrumQueue() { return spectrumQueue; }
 
     // Data logging functions
     void startLogging();
     void stopLogging();
     bool isCurrentlyLogging() const { return isLogging.load(); }
-    void exportToCSV();
+    // Writes CSV, or a binary session for .aas files; false if an export is already running
+    bool exportSession(const juce::File& destination);
+    const SessionExporter& getSessionExporter() const { return sessionExporter; }
+    void cancelExport() { sessionExporter.cancel(); }
     double getRecordingTime() const;
-    int getDataPointCount() const { return static_cast<int>(dataLog.size()); }
+    int getDataPointCount() const { return dataLogger.getNumPoints(); }
+
+    // Analysis resolution. The frame rate is independent of fftSize; the hop is
+    // clamped to fftSize so consecutive frames never leave gaps.
+    void setAnalysisFrameRate(double framesPerSecond);
+    void setAnalysisOverlap(STFTProcessor::Overlap overlap);
+    double getAnalysisFrameRate() const { return currentSampleRate / requestedHopSize.load(); }
+
+    // Analysis streams: one per input channel, plus mid/side (stereo only) and the channel
+    // average when enabled. Every stream is logged; the getters above show the displayed one.
+    void setMidSideAnalysisEnabled(bool shouldBeEnabled) { requestedMidSide.store(shouldBeEnabled); }
+    void setChannelSumAnalysisEnabled(bool shouldBeEnabled) { requestedSum.store(shouldBeEnabled); }
+    bool isMidSideAnalysisEnabled() const { return requestedMidSide.load(); }
+    bool isChannelSumAnalysisEnabled() const { return requestedSum.load(); }
+    juce::StringArray getAnalysisStreamNames() const;
+    void setDisplayedStream(int stream) { displayedStream.store(stream); }
+    int getDisplayedStream() const { return displayedStream.load(); }
+
+    // Loudness calibration: the dB SPL at the listening position of a full-scale RMS of 1.
+    // Loudness, sharpness and roughness are only absolute once it matches the playback.
+    void setFullScaleLevel(float dBSPL) { requestedFullScaleLevel.store(dBSPL); }
+    float getFullScaleLevel() const { return requestedFullScaleLevel.load(); }
 
 private:
-    // FFT setup
-    static constexpr int fftOrder = 11;
-    static constexpr int fftSize = 1 << fftOrder; // 2048
-    juce::dsp::FFT fft;
-    juce::dsp::WindowingFunction<float> window;
-
-    std::array<float, fftSize * 2> fftData;
-    int fftPos = 0;
-
-    // Analysis parameters (atomic for thread safety)
-    std::atomic<float> spectralCentroid{ 0.0f };
-    std::atomic<float> spectralHarshness{ 0.0f };
-    std::atomic<float> rmsLevel{ 0.0f };
-    std::atomic<float> dynamicVariability{ 0.0f };
-    std::atomic<float> temporalUnpredictability{ 0.0f };
-    std::atomic<float> acousticActivationScore{ 50.0f }; // 0-100 scale
-
-    // RMS history for dynamic analysis
-    static constexpr int rmsHistorySize = 100;
-    std::array<float, rmsHistorySize> rmsHistory{};
-    int rmsHistoryPos = 0;
+    static constexpr int fftSize = AcousticAnalysisEngine::fftSize;
+
+    // Runs on the analysis thread only
+    MultichannelAnalysisEngine engine;
+
+    // Requested resolution; a frame rate of 0 means the overlap setting is used instead
+    double analysisFrameRate = AcousticAnalysisEngine::defaultFrameRate;
+    STFTProcessor::Overlap analysisOverlap = STFTProcessor::Overlap::half;
+    std::atomic<int> requestedHopSize{ fftSize / 2 };
+
+    // Requested stream layout, applied by the analysis thread
+    std::atomic<bool> requestedMidSide{ false };
+    std::atomic<bool> requestedSum{ false };
+    std::atomic<int> displayedStream{ 0 };
+
+    // Requested loudness calibration, applied by the analysis thread
+    std::atomic<float> requestedFullScaleLevel{ MultichannelAnalysisEngine::Options().fullScaleLevel };
+
+    // BS.1770 weight per input channel, from the bus layout (written in prepareToPlay)
+    std::vector<float> loudnessWeights;
+
+    // Set by startLogging: the analysis thread restarts every session-long measurement
+    std::atomic<bool> integrationResetRequested{ false };
+
+    // Names of the engine's current streams, for the editor
+    juce::CriticalSection streamNamesLock;
+    juce::StringArray streamNames;
+
+    // Published by the analysis thread, read by the editor
+    SeqLock<FeatureSnapshot> latestFeatures;
+    SpectrumQueue spectrumQueue{ fftSize / 2, 32 };
 
     double currentSampleRate = 44100.0;
 
-    // Data logging
-    struct DataPoint
-    {
-        double timestamp;
-        float activationScore;
-        float spectralCentroid;
-        float spectralHarshness;
-        float dynamicVariability;
-        float temporalUnpredictability;
-        float rmsLevel;
-    };
-
-    std::vector<DataPoint> dataLog;
+    // Data logging. Timestamps come from the sample count, not the wall clock
+    DataLogger dataLogger;
     std::atomic<bool> isLogging{ false };
-    juce::int64 loggingStartTime = 0;
-    juce::CriticalSection dataLogLock;
-
-    // Analysis functions
-    void performFFTAnalysis();
-    void calculateSpectralCentroid();
-    void calculateSpectralHarshness();
-    void calculateDynamicVariability();
-    void calculateTemporalUnpredictability();
-    void calculateAcousticActivationScore();
-    void logDataPoint();
+    SessionClock sessionClock;
+    SessionExporter sessionExporter;
+
+    // Stream position of the engine's first sample; moves when the stream layout changes and
+    // past samples the worker dropped (analysis thread)
+    juce::int64 samplesAnalysed = 0;
+    juce::int64 engineStartSample = 0;
+
+    // Analysis thread; declared last so it stops before anything it touches is destroyed
+    AnalysisWorker analysisWorker{ [this](const float* const* channels, int numChannels, int numSamples)
+        {
+            analyseSamples(channels, numChannels, numSamples);
+        },
+        [this](int numSamples)
+        {
+            skipDroppedSamples(numSamples);
+        } };
+
+    // Analysis functions (analysis thread)
+    void analyseSamples(const float* const* channels, int numChannels, int numSamples);
+    void skipDroppedSamples(int numSamples);
+    void publishFrame(const AnalysisFrame& frame, int stream, int numStreams);
+    void logDataPoint(const AnalysisFrame& frame, int stream, const SessionClock::Timestamp& timestamp);
+    void updateRequestedHopSize();
+    void prepareEngine(int numChannels);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioPluginAudioProcessor)
 };
\ No newline at end of file
@@ -0,0 +1,254 @@
+#include "SpectrogramComponent.h"
+
+//==============================================================================
+SpectrogramComponent::SpectrogramComponent(SpectrumQueue& queueToUse)
+    : queue(queueToUse),
+    incoming((size_t)queueToUse.getNumBins(), 0.0f),
+    powerPrefix((size_t)queueToUse.getNumBins() + 1, 0.0)
+{
+    // The analysis window is normalised to a mean of 1, so a full-scale sine peaks at fftSize / 2 = numBins
+    magnitudeScale = 1.0f / static_cast<float>(queue.getNumBins());
+
+    buildColourTable();
+    setOpaque(true);
+
+    // Whatever queued up while the editor was closed is stale; start from the next frame
+    queue.discardAll();
+}
+
+void SpectrogramComponent::setSampleRate(double newSampleRate)
+{
+    if (newSampleRate <= 0.0 || newSampleRate == sampleRate)
+        return;
+
+    sampleRate = newSampleRate;
+    rebuildTables();
+}
+
+void SpectrogramComponent::setOctaveSmoothing(int bandsPerOctave)
+{
+    smoothingBandsPerOctave = juce::jmax(0, bandsPerOctave);
+    rebuildTables();
+    repaint(getLiveArea());
+}
+
+void SpectrogramComponent::setLiveSpectrumVisible(bool shouldBeVisible)
+{
+    if (liveSpectrumVisible == shouldBeVisible)
+        return;
+
+    liveSpectrumVisible = shouldBeVisible;
+    resized();
+    repaint();
+}
+
+void SpectrogramComponent::buildColourTable()
+{
+    // Black through purple and orange to pale yellow
+    juce::ColourGradient gradient(juce::Colour(0xff000004), 0.0f, 0.0f, juce::Colour(0xfffcfdbf), 1.0f, 0.0f, false);
+    gradient.addColour(0.25, juce::Colour(0xff3b0f70));
+    gradient.addColour(0.50, juce::Colour(0xff8c2981));
+    gradient.addColour(0.75, juce::Colour(0xfffe9f6d));
+
+    for (size_t i = 0; i < colourTable.size(); ++i)
+        colourTable[i] = gradient.getColourAtPosition(static_cast<double>(i) / static_cast<double>(colourTable.size() - 1)).getPixelARGB();
+}
+
+//==============================================================================
+float SpectrogramComponent::getFrequencyForRow(float row) const noexcept
+{
+    const auto maxFrequency = static_cast<float>(sampleRate * 0.5);
+    const auto numRows = static_cast<float>(juce::jmax(1, getHistoryArea().getHeight()));
+    return minFrequency * std::pow(maxFrequency / minFrequency, 1.0f - row / numRows);
+}
+
+float SpectrogramComponent::getRowForFrequency(float frequency) const noexcept
+{
+    const auto maxFrequency = static_cast<float>(sampleRate * 0.5);
+    const auto numRows = static_cast<float>(juce::jmax(1, getHistoryArea().getHeight()));
+    return numRows * (1.0f - std::log(frequency / minFrequency) / std::log(maxFrequency / minFrequency));
+}
+
+float SpectrogramComponent::getLevel(float power) const noexcept
+{
+    const auto db = 10.0f * std::log10(power * magnitudeScale * magnitudeScale + 1.0e-20f);
+    return juce::jlimit(0.0f, 1.0f, (db - floorDb) / -floorDb);
+}
+
+juce::Rectangle<int> SpectrogramComponent::getHistoryArea() const
+{
+    auto area = getLocalBounds();
+
+    if (liveSpectrumVisible)
+        area.removeFromRight(liveStripWidth);
+
+    return area;
+}
+
+juce::Rectangle<int> SpectrogramComponent::getLiveArea() const
+{
+    return liveSpectrumVisible ? getLocalBounds().removeFromRight(liveStripWidth) : juce::Rectangle<int>();
+}
+
+void SpectrogramComponent::rebuildTables()
+{
+    const auto numRows = getHistoryArea().getHeight();
+    const auto numBins = queue.getNumBins();
+    const auto binWidth = static_cast<float>(sampleRate) / static_cast<float>(numBins * 2);
+
+    auto toBin = [numBins, binWidth](float frequency)
+        {
+            return juce::jlimit(1, numBins - 1, static_cast<int>(frequency / binWidth));
+        };
+
+    rowBinStart.assign((size_t)numRows, 1);
+    rowBinEnd.assign((size_t)numRows, 2);
+    smoothBinStart.assign((size_t)numRows, 1);
+    smoothBinEnd.assign((size_t)numRows, 2);
+    liveLevels.assign((size_t)numRows, 0.0f);
+
+    const auto halfBand = smoothingBandsPerOctave > 0 ? std::pow(2.0f, 0.5f / static_cast<float>(smoothingBandsPerOctave)) : 1.0f;
+
+    for (int row = 0; row < numRows; ++row)
+    {
+        // Rows narrower than a bin show the bin they fall in; wider rows take the loudest bin
+        const auto start = toBin(getFrequencyForRow(static_cast<float>(row + 1)));
+        const auto end = juce::jmax(start + 1, juce::jmin(numBins, toBin(getFrequencyForRow(static_cast<float>(row))) + 1));
+        rowBinStart[(size_t)row] = start;
+        rowBinEnd[(size_t)row] = end;
+
+        const auto centre = getFrequencyForRow(static_cast<float>(row) + 0.5f);
+        const auto smoothStart = toBin(centre / halfBand);
+        smoothBinStart[(size_t)row] = smoothStart;
+        smoothBinEnd[(size_t)row] = juce::jmax(smoothStart + 1, juce::jmin(numBins, toBin(centre * halfBand) + 1));
+    }
+}
+
+//==============================================================================
+void SpectrogramComponent::update()
+{
+    bool anyAdded = false;
+
+    while (queue.pop(incoming.data()))
+    {
+        addColumn(incoming.data());
+        anyAdded = true;
+    }
+
+    if (!anyAdded)
+        return;
+
+    updateLiveSpectrum(incoming.data());
+
+    // The frequency ticks are drawn over the history, so these two cover everything that changed
+    repaint(getHistoryArea());
+
+    if (liveSpectrumVisible)
+        repaint(getLiveArea());
+}
+
+void SpectrogramComponent::addColumn(const float* magnitudes)
+{
+    if (!history.isValid())
+        return;
+
+    juce::Image::BitmapData pixels(history, writeColumn, 0, 1, history.getHeight(), juce::Image::BitmapData::writeOnly);
+
+    for (int row = 0; row < history.getHeight(); ++row)
+    {
+        float peak = 0.0f;
+
+        for (int bin = rowBinStart[(size_t)row]; bin < rowBinEnd[(size_t)row]; ++bin)
+            peak = juce::jmax(peak, magnitudes[bin]);
+
+        const auto index = static_cast<size_t>(getLevel(peak * peak) * static_cast<float>(colourTable.size() - 1));
+        *reinterpret_cast<juce::PixelARGB*>(pixels.getPixelPointer(0, row)) = colourTable[index];
+    }
+
+    writeColumn = (writeColumn + 1) % history.getWidth();
+}
+
+void SpectrogramComponent::updateLiveSpectrum(const float* magnitudes)
+{
+    if (!liveSpectrumVisible)
+        return;
+
+    const auto numBins = queue.getNumBins();
+
+    // Prefix sum of bin powers: any band's mean power is then one subtraction
+    for (int bin = 0; bin < numBins; ++bin)
+        powerPrefix[(size_t)bin + 1] = powerPrefix[(size_t)bin] + static_cast<double>(magnitudes[bin]) * magnitudes[bin];
+
+    for (size_t row = 0; row < liveLevels.size(); ++row)
+    {
+        const auto start = smoothingBandsPerOctave > 0 ? smoothBinStart[row] : rowBinStart[row];
+        const auto end = smoothingBandsPerOctave > 0 ? smoothBinEnd[row] : rowBinEnd[row];
+        const auto meanPower = (powerPrefix[(size_t)end] - powerPrefix[(size_t)start]) / (end - start);
+
+        liveLevels[row] = getLevel(static_cast<float>(meanPower));
+    }
+}
+
+//==============================================================================
+void SpectrogramComponent::resized()
+{
+    const auto area = getHistoryArea();
+
+    history = juce::Image(juce::Image::ARGB, juce::jmax(1, area.getWidth()), juce::jmax(1, area.getHeight()), true);
+    history.clear(history.getBounds(), juce::Colour(0xff000004));
+    writeColumn = 0;
+
+    rebuildTables();
+}
+
+void SpectrogramComponent::paint(juce::Graphics& g)
+{
+    const auto area = getHistoryArea();
+    const auto width = history.getWidth();
+    const auto height = history.getHeight();
+
+    // Oldest columns on the left, newest on the right
+    g.drawImage(history, area.getX(), area.getY(), width - writeColumn, height, writeColumn, 0, width - writeColumn, height);
+
+    if (writeColumn > 0)
+        g.drawImage(history, area.getX() + width - writeColumn, area.getY(), writeColumn, height, 0, 0, writeColumn, height);
+
+    // Frequency ticks
+    g.setFont(10.0f);
+
+    for (auto frequency : { 100.0f, 1000.0f, 10000.0f })
+    {
+        if (frequency >= sampleRate * 0.5)
+            continue;
+
+        const auto y = area.getY() + juce::roundToInt(getRowForFrequency(frequency));
+        g.setColour(juce::Colours::white.withAlpha(0.3f));
+        g.drawHorizontalLine(y, static_cast<float>(area.getX()), static_cast<float>(area.getRight()));
+        g.setColour(juce::Colours::lightgrey);
+        g.drawText(frequency >= 1000.0f ? juce::String(frequency / 1000.0f, 0) + "k" : juce::String(frequency, 0),
+            area.getX() + 2, y - 12, 30, 12, juce::Justification::left);
+    }
+
+    if (!liveSpectrumVisible)
+        return;
+
+    const auto live = getLiveArea();
+    g.setColour(juce::Colour(0xff222222));
+    g.fillRect(live);
+
+    juce::Path path;
+
+    for (size_t row = 0; row < liveLevels.size(); ++row)
+    {
+        const auto x = static_cast<float>(live.getX()) + liveLevels[row] * static_cast<float>(live.getWidth());
+        const auto y = static_cast<float>(live.getY()) + static_cast<float>(row) + 0.5f;
+
+        if (row == 0)
+            path.startNewSubPath(x, y);
+        else
+            path.lineTo(x, y);
+    }
+
+    g.setColour(juce::Colour(0xff2196F3));
+    g.strokePath(path, juce::PathStrokeType(1.0f));
+}
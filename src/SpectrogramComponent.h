@@ -0,0 +1,77 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "SpectrumQueue.h"
+#include <array>
+#include <vector>
+
+//==============================================================================
+/**
+    Scrolling spectrogram with an optional live spectrum strip on its right.
+
+    Spectra arrive from the analysis thread through a SpectrumQueue. Each one is mapped
+    onto log-spaced frequency rows with precomputed bin ranges, coloured through a
+    lookup table and written as a single column of a ring-buffered image. paint() draws
+    that image in two blits, oldest columns first, so nothing is ever redrawn from
+    scratch.
+
+    The live strip shows the latest spectrum on the same frequency rows, optionally
+    smoothed to 1/n octave. Band averages are taken from a prefix sum of bin powers, so
+    each row costs two lookups whatever its bandwidth.
+*/
+class SpectrogramComponent : public juce::Component
+{
+public:
+    explicit SpectrogramComponent(SpectrumQueue& queueToUse);
+
+    /** Rebuilds the frequency mapping if the rate changed. */
+    void setSampleRate(double newSampleRate);
+
+    /** Bands per octave for the live spectrum, or 0 for unsmoothed. */
+    void setOctaveSmoothing(int bandsPerOctave);
+    void setLiveSpectrumVisible(bool shouldBeVisible);
+
+    /** Message thread. Drains the queue, adding one column per spectrum, and repaints the history and live areas if anything arrived. */
+    void update();
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    static constexpr float minFrequency = 20.0f;
+    static constexpr float floorDb = -100.0f;
+    static constexpr int liveStripWidth = 80;
+
+    void rebuildTables();
+    void buildColourTable();
+    void addColumn(const float* magnitudes);
+    void updateLiveSpectrum(const float* magnitudes);
+
+    float getFrequencyForRow(float row) const noexcept;
+    float getRowForFrequency(float frequency) const noexcept;
+    float getLevel(float power) const noexcept;
+    juce::Rectangle<int> getHistoryArea() const;
+    juce::Rectangle<int> getLiveArea() const;
+
+    SpectrumQueue& queue;
+    std::vector<float> incoming;
+
+    double sampleRate = 44100.0;
+    int smoothingBandsPerOctave = 3;
+    bool liveSpectrumVisible = true;
+
+    // Ring-buffered history; writeColumn is the next column to overwrite, i.e. the oldest
+    juce::Image history;
+    int writeColumn = 0;
+
+    // Per image row, top row highest: bins shown in the spectrogram and averaged in the live strip
+    std::vector<int> rowBinStart, rowBinEnd;
+    std::vector<int> smoothBinStart, smoothBinEnd;
+    std::vector<double> powerPrefix;
+    std::vector<float> liveLevels;
+
+    std::array<juce::PixelARGB, 256> colourTable;
+    float magnitudeScale = 1.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrogramComponent)
+};
@@ -0,0 +1,235 @@
+#include "AcousticAnalysisEngine.h"
+
+//==============================================================================
+AcousticAnalysisEngine::AcousticAnalysisEngine()
+{
+    prepare(currentSampleRate);
+}
+
+void AcousticAnalysisEngine::prepare(double sampleRate, const PerceptualFilterbank::Options& filterbankOptions)
+{
+    currentSampleRate = sampleRate;
+    spectralKernel.prepare(sampleRate, fftSize);
+    tonality.prepare(sampleRate, fftSize);
+
+    // The frame only has room for numMFCCs coefficients
+    auto options = filterbankOptions;
+    options.numCoefficients = juce::jlimit(0, AnalysisFrame::numMFCCs, options.numCoefficients);
+    filterbank.prepare(sampleRate, fftSize, options);
+    octaveBands.prepare(sampleRate);
+    soundLevels.prepare(sampleRate, getSoundLevelOptions());
+    zwickerLoudness.prepare(octaveBands, zwickerLoudness.getOptions());
+    psychoacoustics.prepare(octaveBands, psychoacoustics.getOptions());
+    dynamics.prepare(sampleRate, getDynamicsOptions());
+
+    reset();
+}
+
+void AcousticAnalysisEngine::reset()
+{
+    stft.reset();
+    tonality.reset();
+    octaveBands.reset();
+    soundLevels.reset();
+    zwickerLoudness.reset();
+    psychoacoustics.reset();
+    dynamics.reset();
+    sessionStatistics.reset();
+    framesProcessed = 0;
+    frame = {};
+}
+
+void AcousticAnalysisEngine::setFullScaleLevel(float newLevel) noexcept
+{
+    zwickerLoudness.setFullScaleLevel(newLevel);
+    psychoacoustics.setFullScaleLevel(newLevel);
+}
+
+void AcousticAnalysisEngine::filterSamples(const float* samples, int numSamples) noexcept
+{
+    for (int offset = 0; offset < numSamples; offset += maxFilterBlockSize)
+    {
+        const auto count = juce::jmin(maxFilterBlockSize, numSamples - offset);
+        octaveBands.process(samples + offset, count);
+        soundLevels.process(samples + offset, count);
+        dynamics.process(samples + offset, count);
+        zwickerLoudness.process(octaveBands);
+    }
+}
+
+void AcousticAnalysisEngine::analyseFrame(const float* magnitudes)
+{
+    frame.frameIndex = framesProcessed++;
+    frame.endSample = stft.getNumSamplesProcessed();
+    frame.centreSample = frame.endSample - fftSize / 2;
+
+    // Calculate RMS over the samples that arrived since the previous frame
+    frame.rmsLevel = stft.getLatestHopRMS();
+
+    // Calculate metrics
+    calculateSpectralFeatures(magnitudes);
+    calculatePerceptualBands(magnitudes);
+    calculateTonality(magnitudes);
+    octaveBands.readLevels(frame.thirdOctaveLevels.data(), frame.octaveLevels.data());
+    calculateSoundLevels();
+    calculateLoudness();
+    calculatePsychoacoustics();
+    calculateDynamicVariability();
+    calculateTemporalUnpredictability();
+    calculateAcousticActivationScore();
+    updateSessionStatistics();
+}
+
+void AcousticAnalysisEngine::processStage(Stage stage, const float* magnitudes)
+{
+    jassert(magnitudes != nullptr || stage > Stage::tonality);
+
+    switch (stage)
+    {
+        case Stage::spectralFeatures:         calculateSpectralFeatures(magnitudes); break;
+        case Stage::perceptualBands:          calculatePerceptualBands(magnitudes); break;
+        case Stage::tonality:                 calculateTonality(magnitudes); break;
+        case Stage::soundLevels:              calculateSoundLevels(); break;
+        case Stage::loudness:                 calculateLoudness(); break;
+        case Stage::psychoacoustics:          calculatePsychoacoustics(); break;
+        case Stage::dynamicVariability:       calculateDynamicVariability(); break;
+        case Stage::temporalUnpredictability: calculateTemporalUnpredictability(); break;
+        case Stage::activationScore:          calculateAcousticActivationScore(); break;
+    }
+}
+
+void AcousticAnalysisEngine::calculateSpectralFeatures(const float* magnitudes)
+{
+    // One fused pass over the spectrum for every spectral metric
+    auto features = spectralKernel.process(magnitudes);
+
+    // Normalize to 0-1 range (assuming 0-8000 Hz is relevant range)
+    frame.spectralCentroid = juce::jlimit(0.0f, 1.0f, features.centroidHz / 8000.0f);
+
+    // Harshness correlates with high-frequency energy (>2kHz) and roughness
+    // Simple metric: ratio of high-freq energy to total energy
+    float harshness = features.totalMagnitude > 0.0f ? features.highBandMagnitude / features.totalMagnitude : 0.0f;
+    frame.spectralHarshness = juce::jlimit(0.0f, 1.0f, harshness * 2.0f); // Scale up for visibility
+
+    frame.spectralSpread = features.spreadHz;
+    frame.spectralRolloff = features.rolloffHz;
+    frame.spectralFlatness = features.flatness;
+    frame.spectralEntropy = features.entropy;
+}
+
+void AcousticAnalysisEngine::calculatePerceptualBands(const float* magnitudes)
+{
+    filterbank.process(magnitudes);
+
+    const auto* coefficients = filterbank.getCoefficients();
+
+    for (int i = 0; i < filterbank.getNumCoefficients(); ++i)
+        frame.mfcc[(size_t)i] = coefficients[i];
+}
+
+void AcousticAnalysisEngine::calculateTonality(const float* magnitudes)
+{
+    tonality.process(magnitudes);
+    frame.numTonalComponents = tonality.getNumPersistentTones();
+
+    if (const auto* tone = tonality.getMostProminentTone())
+    {
+        frame.tonalFrequency = tone->frequency;
+        frame.toneToNoiseRatio = tone->toneToNoiseRatio;
+        frame.prominenceRatio = tone->prominenceRatio;
+    }
+    else
+    {
+        frame.tonalFrequency = frame.toneToNoiseRatio = frame.prominenceRatio = 0.0f;
+    }
+}
+
+void AcousticAnalysisEngine::calculateSoundLevels()
+{
+    using Weighting = SoundLevelMeter::Weighting;
+
+    for (int period = 0; period < SoundLevelMeter::numPeriods; ++period)
+    {
+        frame.aWeightedLeq[(size_t)period] = soundLevels.getEquivalentLevel(Weighting::a, period);
+        frame.cWeightedLeq[(size_t)period] = soundLevels.getEquivalentLevel(Weighting::c, period);
+        frame.zWeightedLeq[(size_t)period] = soundLevels.getEquivalentLevel(Weighting::z, period);
+    }
+
+    for (auto mode : { TimeWeighting::Mode::fast, TimeWeighting::Mode::slow, TimeWeighting::Mode::impulse })
+    {
+        frame.aWeightedLevels[(size_t)mode] = soundLevels.getTimeWeightedLevel(Weighting::a, mode);
+        frame.aWeightedMaxLevels[(size_t)mode] = soundLevels.getMaxTimeWeightedLevel(Weighting::a, mode);
+    }
+
+    frame.cWeightedPeak = soundLevels.getPeakLevel(Weighting::c);
+    frame.zWeightedPeak = soundLevels.getPeakLevel(Weighting::z);
+}
+
+void AcousticAnalysisEngine::calculateLoudness()
+{
+    frame.loudnessSones = zwickerLoudness.getLoudness();
+    frame.loudnessPhons = zwickerLoudness.getLoudnessLevel();
+    frame.loudnessN5 = zwickerLoudness.getPercentileLoudness(5.0f);
+    frame.loudnessN10 = zwickerLoudness.getPercentileLoudness(10.0f);
+}
+
+void AcousticAnalysisEngine::calculatePsychoacoustics()
+{
+    // Reuses the band envelopes and the specific loudness the stages above already produced
+    psychoacoustics.processEnvelopes(octaveBands);
+    frame.sharpness = psychoacoustics.calculateSharpness(zwickerLoudness);
+    frame.roughness = psychoacoustics.calculateRoughness(frame.thirdOctaveLevels.data());
+
+    // 1 acum (a 1 kHz band of noise) reads 0 and 3 acum reads 1; 1 asper is fully rough
+    const auto sharpnessScore = juce::jlimit(0.0f, 1.0f, (frame.sharpness - 1.0f) * 0.5f);
+    const auto roughnessScore = juce::jlimit(0.0f, 1.0f, frame.roughness);
+    frame.psychoacousticHarshness = 0.5f * (sharpnessScore + roughnessScore);
+}
+
+void AcousticAnalysisEngine::calculateDynamicVariability()
+{
+    // Standard deviation of the 10 ms envelope; every window is kept up to date as the
+    // envelope advances, so reading them costs nothing per frame
+    frame.dynamicVariability = dynamics.getVariability();
+
+    for (int i = 0; i < DynamicsAnalyzer::numTimescales; ++i)
+        frame.dynamicVariabilityByTimescale[(size_t)i] = dynamics.getVariability(i);
+}
+
+void AcousticAnalysisEngine::calculateTemporalUnpredictability()
+{
+    // Mean change between consecutive envelope frames, per second
+    frame.temporalUnpredictability = dynamics.getUnpredictability();
+
+    for (int i = 0; i < DynamicsAnalyzer::numTimescales; ++i)
+        frame.temporalUnpredictabilityByTimescale[(size_t)i] = dynamics.getUnpredictability(i);
+}
+
+void AcousticAnalysisEngine::calculateAcousticActivationScore()
+{
+    // Composite score: lower values for stress-inducing features
+    // Research-based weights (these are initial estimates - refine with your research!)
+
+    float centroidScore = (1.0f - frame.spectralCentroid) * 100.0f; // Lower centroid = calmer
+    const auto harshness = usePsychoacousticHarshness ? frame.psychoacousticHarshness : frame.spectralHarshness;
+    float harshnessScore = (1.0f - harshness) * 100.0f; // Lower harshness = better
+    float dynamicScore = (1.0f - frame.dynamicVariability) * 100.0f; // Lower variability = calmer
+    float unpredictScore = (1.0f - frame.temporalUnpredictability) * 100.0f; // More predictable = calmer
+
+    // Weighted average (adjust weights based on your research)
+    float score = (centroidScore * 0.25f +
+        harshnessScore * 0.35f +
+        dynamicScore * 0.20f +
+        unpredictScore * 0.20f);
+
+    frame.acousticActivationScore = juce::jlimit(0.0f, 100.0f, score);
+}
+
+void AcousticAnalysisEngine::updateSessionStatistics()
+{
+    sessionStatistics.add(frame);
+
+    for (int f = 0; f < SessionStatistics::numFeatures; ++f)
+        for (int p = 0; p < SessionStatistics::numPercentiles; ++p)
+            frame.sessionPercentiles[(size_t)f][(size_t)p] = sessionStatistics.getPercentile(f, p);
+}
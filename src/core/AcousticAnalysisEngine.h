@@ -0,0 +1,250 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "DynamicsAnalyzer.h"
+#include "LoudnessMeter.h"
+#include "OctaveBandAnalyzer.h"
+#include "PerceptualFilterbank.h"
+#include "PsychoacousticAnalyzer.h"
+#include "SessionStatistics.h"
+#include "SoundLevelMeter.h"
+#include "SpectralFeatureKernel.h"
+#include "STFTProcessor.h"
+#include "TonalityAnalyzer.h"
+#include "ZwickerLoudness.h"
+#include <vector>
+
+//==============================================================================
+/** Everything the analyzer measures for one STFT frame. */
+struct AnalysisFrame
+{
+    static constexpr int numMFCCs = 13;
+
+    juce::int64 frameIndex = 0;
+    juce::int64 endSample = 0;           // samples consumed when the frame completed
+    juce::int64 centreSample = 0;        // stream position of the centre of the analysis window
+
+    float rmsLevel = 0.0f;
+    float spectralCentroid = 0.0f;       // 0-1 (0-8000 Hz)
+    float spectralHarshness = 0.0f;      // 0-1
+    float dynamicVariability = 0.0f;     // 0-1, over the last 2.5 s of 10 ms RMS frames
+    float temporalUnpredictability = 0.0f; // 0-1, likewise
+    float acousticActivationScore = 50.0f; // 0-100
+    float spectralSpread = 0.0f;         // Hz
+    float spectralRolloff = 0.0f;        // Hz
+    float spectralFlatness = 0.0f;       // 0-1
+    float spectralEntropy = 0.0f;        // 0-1
+    float sharpness = 0.0f;              // acum, DIN 45692
+    float roughness = 0.0f;              // asper
+    float psychoacousticHarshness = 0.0f; // 0-1, from sharpness and roughness
+
+    // Zwicker time-varying loudness at the frame end, and its percentiles over the session
+    float loudnessSones = 0.0f;
+    float loudnessPhons = 0.0f;
+    float loudnessN5 = 0.0f;             // sone, exceeded 5 % of the time
+    float loudnessN10 = 0.0f;            // sone, exceeded 10 % of the time
+
+    // ECMA-418-1 ratios of the most prominent persistent tone; all 0 when there is none
+    float tonalFrequency = 0.0f;         // Hz
+    float toneToNoiseRatio = 0.0f;       // dB
+    float prominenceRatio = 0.0f;        // dB
+    int numTonalComponents = 0;          // persistent tones in the frame
+
+    // BS.1770 programme loudness of all input channels up to the end of this frame, the
+    // same for every stream of a hop. Filled in by whoever owns the LoudnessMeter
+    // (MultichannelAnalysisEngine); AcousticAnalysisEngine alone leaves them at the floor.
+    float momentaryLoudness = LoudnessMeter::minimumLoudness;   // LUFS, 400 ms
+    float shortTermLoudness = LoudnessMeter::minimumLoudness;   // LUFS, 3 s
+    float integratedLoudness = LoudnessMeter::minimumLoudness;  // LUFS, gated, since the last integration reset
+    float loudnessRange = 0.0f;                                 // LU
+
+    // IEC 61672 levels of this stream up to the end of the frame, dB re full scale. One Leq
+    // per SoundLevelMeter period (1 s, 1 min, 15 min, session); maxima cover the session.
+    std::array<float, SoundLevelMeter::numPeriods> aWeightedLeq{};
+    std::array<float, SoundLevelMeter::numPeriods> cWeightedLeq{};
+    std::array<float, SoundLevelMeter::numPeriods> zWeightedLeq{};
+    std::array<float, TimeWeighting::numModes> aWeightedLevels{};      // LAF, LAS, LAI
+    std::array<float, TimeWeighting::numModes> aWeightedMaxLevels{};   // LAFmax, LASmax, LAImax
+    float cWeightedPeak = SoundLevelMeter::minimumLevel;       // LCpeak
+    float zWeightedPeak = SoundLevelMeter::minimumLevel;       // LZpeak
+
+    // Variability and unpredictability per DynamicsAnalyzer timescale (1 s, 10 s, 1 min, 10 min)
+    std::array<float, DynamicsAnalyzer::numTimescales> dynamicVariabilityByTimescale{};
+    std::array<float, DynamicsAnalyzer::numTimescales> temporalUnpredictabilityByTimescale{};
+
+    // Band levels over the hop ending at this frame, dB re full-scale RMS
+    std::array<float, OctaveBandAnalyzer::numThirdOctaveBands> thirdOctaveLevels{};
+    std::array<float, OctaveBandAnalyzer::numOctaveBands> octaveLevels{};
+
+    // Session percentiles of this stream up to this frame, [feature][percentile], in the
+    // order of SessionStatistics::Feature and SessionStatistics::percentages (L10 to L95)
+    std::array<std::array<float, SessionStatistics::numPercentiles>, SessionStatistics::numFeatures> sessionPercentiles{};
+
+    // Cepstral coefficients of the perceptual filterbank; unused trailing entries stay 0
+    std::array<float, numMFCCs> mfcc{};
+};
+
+//==============================================================================
+/**
+    Entry point of the AcousticAnalysisCore library: the analysis pipeline shared by the
+    plugin and the offline tools, usable without a juce::AudioProcessor.
+
+    Takes a mono sample stream in blocks of any size and produces one AnalysisFrame per STFT frame.
+    Results depend only on the samples and the hop, never on how the stream was split
+    into blocks, so an offline run reproduces the plugin frame for frame.
+*/
+class AcousticAnalysisEngine
+{
+public:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder; // 2048
+    static constexpr double defaultFrameRate = 40.0;
+
+    /** The per-frame analysis stages, in the order every frame runs them. */
+    enum class Stage
+    {
+        spectralFeatures,           // read the magnitude spectrum
+        perceptualBands,
+        tonality,
+        soundLevels,                // read the state the time signal left behind
+        loudness,
+        psychoacoustics,
+        dynamicVariability,
+        temporalUnpredictability,
+        activationScore
+    };
+
+    AcousticAnalysisEngine();
+
+    /** Allocates and resets. Not real-time safe. */
+    void prepare(double sampleRate, const PerceptualFilterbank::Options& filterbankOptions = {});
+
+    /** The sound level meter options of every engine; the frame's Leqs follow their periods. */
+    static SoundLevelMeter::Options getSoundLevelOptions() noexcept { return {}; }
+
+    /** The dynamics options of every engine; the frame's per-timescale values follow them. */
+    static DynamicsAnalyzer::Options getDynamicsOptions() noexcept { return {}; }
+    void reset();
+
+    void setHopSize(int newHopSize) { stft.setHopSize(newHopSize); }
+    int getHopSize() const noexcept { return stft.getHopSize(); }
+    double getSampleRate() const noexcept { return currentSampleRate; }
+
+    /** Magnitude spectrum of the latest frame; only meaningful inside a process() callback. */
+    const float* getMagnitudes() const noexcept { return stft.getMagnitudes(); }
+    int getNumBins() const noexcept { return stft.getNumBins(); }
+
+    /** Perceptual band energies of the latest frame; also only meaningful inside a process() callback. */
+    const PerceptualFilterbank& getFilterbank() const noexcept { return filterbank; }
+
+    /**
+        Makes the activation score use psychoacousticHarshness instead of spectralHarshness.
+        Both are always calculated; this only picks the score's input.
+    */
+    void setUsePsychoacousticHarshness(bool shouldUse) noexcept { usePsychoacousticHarshness = shouldUse; }
+    bool isUsingPsychoacousticHarshness() const noexcept { return usePsychoacousticHarshness; }
+
+    /**
+        Calibration of the loudness, sharpness and roughness: the dB SPL of a full-scale RMS
+        of 1, 100 by default. It survives prepare() and takes effect from the next step.
+    */
+    void setFullScaleLevel(float newLevel) noexcept;
+    float getFullScaleLevel() const noexcept { return zwickerLoudness.getOptions().fullScaleLevel; }
+
+    /** Tones of the latest frame and their tracks. */
+    const TonalityAnalyzer& getTonality() const noexcept { return tonality; }
+
+    /** Levels up to the last sample processed, including any after the latest frame. */
+    const SoundLevelMeter& getSoundLevelMeter() const noexcept { return soundLevels; }
+
+    /** Time-varying loudness up to the last sample processed. */
+    const ZwickerLoudness& getZwickerLoudness() const noexcept { return zwickerLoudness; }
+
+    /** Percentiles of the features of every frame since the last resetSession(). */
+    const SessionStatistics& getSessionStatistics() const noexcept { return sessionStatistics; }
+
+    /**
+        Restarts every Leq interval, the time-weighted maxima, the peaks, the loudness
+        percentiles and the feature percentiles, e.g. when a recording starts.
+    */
+    void resetSession() noexcept
+    {
+        soundLevels.resetSession();
+        zwickerLoudness.resetStatistics();
+        sessionStatistics.reset();
+    }
+
+    /** Feeds samples and calls onFrame(const AnalysisFrame&) for every frame completed. */
+    template <typename FrameCallback>
+    void process(const float* samples, int numSamples, FrameCallback&& onFrame)
+    {
+        // The band and weighting filters run on the time signal; bring them up to each frame's end before analysing it
+        const auto blockStart = stft.getNumSamplesProcessed();
+        int filtered = 0;
+
+        stft.process(samples, numSamples, [&](const float* magnitudes)
+            {
+                const auto frameEnd = static_cast<int>(stft.getNumSamplesProcessed() - blockStart);
+                filterSamples(samples + filtered, frameEnd - filtered);
+                filtered = frameEnd;
+
+                analyseFrame(magnitudes);
+                onFrame(static_cast<const AnalysisFrame&>(frame));
+            });
+
+        filterSamples(samples + filtered, numSamples - filtered);
+    }
+
+    /**
+        Runs one stage on its own and updates only the fields of getLatestFrame() it owns,
+        e.g. to profile it. The first three stages read magnitudes, getNumBins() long; the
+        others read what the last process() left and ignore it.
+    */
+    void processStage(Stage stage, const float* magnitudes = nullptr);
+
+    /** The frame most recently passed to onFrame, with any later processStage() results. */
+    const AnalysisFrame& getLatestFrame() const noexcept { return frame; }
+
+    /** Block in, features out: appends every frame completed inside the block to frames. */
+    void processBlock(const float* samples, int numSamples, std::vector<AnalysisFrame>& frames)
+    {
+        process(samples, numSamples, [&frames](const AnalysisFrame& completed) { frames.push_back(completed); });
+    }
+
+private:
+    // Longest run of samples filtered at once, so the loudness model reads every band power
+    // step before the band analyzer's ring wraps
+    static constexpr int maxFilterBlockSize = 2048;
+
+    void filterSamples(const float* samples, int numSamples) noexcept;
+    void analyseFrame(const float* magnitudes);
+    void calculateSpectralFeatures(const float* magnitudes);
+    void calculatePerceptualBands(const float* magnitudes);
+    void calculateTonality(const float* magnitudes);
+    void calculateSoundLevels();
+    void calculateLoudness();
+    void calculatePsychoacoustics();
+    void calculateDynamicVariability();
+    void calculateTemporalUnpredictability();
+    void calculateAcousticActivationScore();
+    void updateSessionStatistics();
+
+    STFTProcessor stft{ fftOrder };
+    SpectralFeatureKernel spectralKernel;
+    TonalityAnalyzer tonality;
+    PerceptualFilterbank filterbank;
+    OctaveBandAnalyzer octaveBands;
+    SoundLevelMeter soundLevels;
+    ZwickerLoudness zwickerLoudness;
+    PsychoacousticAnalyzer psychoacoustics;
+    DynamicsAnalyzer dynamics;
+    SessionStatistics sessionStatistics;
+    bool usePsychoacousticHarshness = false;
+
+    double currentSampleRate = 44100.0;
+    juce::int64 framesProcessed = 0;
+
+    AnalysisFrame frame;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AcousticAnalysisEngine)
+};
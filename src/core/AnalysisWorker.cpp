@@ -0,0 +1,172 @@
+#include "AnalysisWorker.h"
+#include <limits>
+
+//==============================================================================
+AnalysisWorker::AnalysisWorker(Consumer consumerToUse, DropHandler dropHandlerToUse)
+    : juce::Thread("Acoustic Analysis"),
+    consumer(std::move(consumerToUse)),
+    dropHandler(std::move(dropHandlerToUse))
+{
+}
+
+AnalysisWorker::~AnalysisWorker()
+{
+    release();
+}
+
+void AnalysisWorker::prepare(int numChannelsToUse, int capacityInSamples)
+{
+    release();
+
+    numChannels = juce::jmax(1, numChannelsToUse);
+    capacity = capacityInSamples;
+
+    buffer.assign((size_t)numChannels * (size_t)capacity, 0.0f);
+    readPointers.assign((size_t)numChannels, nullptr);
+    fifo.setTotalSize(capacity);
+    numDroppedSamples.store(0, std::memory_order_relaxed);
+
+    gapFifo.reset();
+    pendingGap = {};
+    numSamplesWritten = 0;
+    numSamplesRead = 0;
+
+    startThread();
+}
+
+void AnalysisWorker::release()
+{
+    stopThread(1000);
+    fifo.reset();
+}
+
+void AnalysisWorker::push(const float* const* channels, int numChannelsToPush, int numSamples) noexcept
+{
+    // Samples written after a gap that isn't queued yet would reach the consumer before it,
+    // so until the gap queue has room they are dropped into the same gap
+    if (pendingGap.numSamples > 0 && !queuePendingGap())
+    {
+        pendingGap.numSamples += numSamples;
+        numDroppedSamples.fetch_add(numSamples, std::memory_order_relaxed);
+        return;
+    }
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto* lane = getChannel(ch);
+
+        // Channels the host didn't provide are analysed as silence
+        if (ch < numChannelsToPush && channels[ch] != nullptr)
+        {
+            if (size1 > 0)
+                juce::FloatVectorOperations::copy(lane + start1, channels[ch], size1);
+
+            if (size2 > 0)
+                juce::FloatVectorOperations::copy(lane + start2, channels[ch] + size1, size2);
+        }
+        else
+        {
+            if (size1 > 0)
+                juce::FloatVectorOperations::clear(lane + start1, size1);
+
+            if (size2 > 0)
+                juce::FloatVectorOperations::clear(lane + start2, size2);
+        }
+    }
+
+    fifo.finishedWrite(size1 + size2);
+    numSamplesWritten += size1 + size2;
+
+    if (size1 + size2 < numSamples)
+    {
+        const auto numDropped = numSamples - (size1 + size2);
+        numDroppedSamples.fetch_add(numDropped, std::memory_order_relaxed);
+
+        pendingGap = { numSamplesWritten, numDropped };
+        queuePendingGap();
+    }
+}
+
+bool AnalysisWorker::queuePendingGap() noexcept
+{
+    int start1, size1, start2, size2;
+    gapFifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 == 0)
+        return false;
+
+    gaps[(size_t)start1] = pendingGap;
+    gapFifo.finishedWrite(1);
+    pendingGap = {};
+    return true;
+}
+
+juce::int64 AnalysisWorker::reportGaps()
+{
+    while (gapFifo.getNumReady() > 0)
+    {
+        int start1, size1, start2, size2;
+        gapFifo.prepareToRead(1, start1, size1, start2, size2);
+        const auto gap = gaps[(size_t)start1];
+
+        if (gap.position > numSamplesRead)
+            return gap.position;
+
+        if (dropHandler != nullptr)
+            dropHandler(gap.numSamples);
+
+        gapFifo.finishedRead(1);
+    }
+
+    return std::numeric_limits<juce::int64>::max();
+}
+
+void AnalysisWorker::consumeRegion(int start, int numSamples)
+{
+    while (numSamples > 0)
+    {
+        // Stop at the next gap, so it is reported between the samples either side of it
+        const auto nextGap = reportGaps();
+        const auto chunk = static_cast<int>(juce::jmin(static_cast<juce::int64>(numSamples), nextGap - numSamplesRead));
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            readPointers[(size_t)ch] = getChannel(ch) + start;
+
+        consumer(readPointers.data(), numChannels, chunk);
+
+        start += chunk;
+        numSamples -= chunk;
+        numSamplesRead += chunk;
+    }
+}
+
+void AnalysisWorker::run()
+{
+    while (!threadShouldExit())
+    {
+        // Gaps at the end of the stream too, or a full gap queue would hold back the samples after them
+        reportGaps();
+
+        const auto numReady = fifo.getNumReady();
+
+        if (numReady == 0)
+        {
+            wait(pollIntervalMs);
+            continue;
+        }
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(numReady, start1, size1, start2, size2);
+
+        if (size1 > 0)
+            consumeRegion(start1, size1);
+
+        if (size2 > 0)
+            consumeRegion(start2, size2);
+
+        fifo.finishedRead(size1 + size2);
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+//==============================================================================
+/**
+    Moves analysis work off the audio thread.
+
+    The audio thread only copies samples into a lock-free single-producer/single-consumer
+    FIFO. A dedicated thread polls the FIFO and hands everything it finds to the consumer
+    callback, in order, so the consumer sees one continuous stream regardless of how the
+    host sliced it into blocks.
+
+    Channels are stored as separate lanes of one buffer (structure of arrays) sharing a
+    single FIFO index, so the consumer receives one contiguous pointer per channel.
+
+    Samples dropped because the FIFO was full are reported to the optional drop handler
+    at the point in the stream where they went missing, so a consumer that counts
+    samples to tell the time can skip over the gap.
+*/
+class AnalysisWorker : private juce::Thread
+{
+public:
+    using Consumer = std::function<void(const float* const* channels, int numChannels, int numSamples)>;
+    using DropHandler = std::function<void(int numSamples)>;
+
+    /** Both callbacks run on the analysis thread, in stream order. */
+    explicit AnalysisWorker(Consumer consumerToUse, DropHandler dropHandlerToUse = nullptr);
+    ~AnalysisWorker() override;
+
+    /** Stops the thread, resizes the FIFO and starts again. Call from prepareToPlay. */
+    void prepare(int numChannels, int capacityInSamples);
+
+    /** Stops the thread and discards anything still queued. */
+    void release();
+
+    /**
+        Audio thread only. Never blocks or allocates; samples that don't fit are dropped.
+        Channels beyond the prepared count are ignored and missing ones are zero-filled.
+    */
+    void push(const float* const* channels, int numChannels, int numSamples) noexcept;
+
+    int getNumChannels() const noexcept { return numChannels; }
+
+    /** Samples lost because the analysis thread fell behind. */
+    int getNumDroppedSamples() const noexcept { return numDroppedSamples.load(std::memory_order_relaxed); }
+
+private:
+    /** Samples dropped after the first position samples of the stream had been written. */
+    struct Gap
+    {
+        juce::int64 position = 0;
+        int numSamples = 0;
+    };
+
+    void run() override;
+    void consumeRegion(int start, int numSamples);
+    bool queuePendingGap() noexcept;
+    juce::int64 reportGaps();
+    float* getChannel(int channel) noexcept { return buffer.data() + (size_t)channel * (size_t)capacity; }
+
+    static constexpr int pollIntervalMs = 5;
+    static constexpr int maxPendingGaps = 32;
+
+    Consumer consumer;
+    DropHandler dropHandler;
+    juce::AbstractFifo fifo{ 1 };
+    std::vector<float> buffer;          // numChannels lanes of capacity samples
+    std::vector<const float*> readPointers;
+    int numChannels = 1;
+    int capacity = 0;
+    std::atomic<int> numDroppedSamples{ 0 };
+
+    // Audio thread to analysis thread. A gap that finds the queue full is held back, and
+    // everything pushed after it dropped into it, until there is room.
+    juce::AbstractFifo gapFifo{ maxPendingGaps };
+    std::array<Gap, (size_t)maxPendingGaps> gaps;
+    Gap pendingGap;                     // audio thread
+    juce::int64 numSamplesWritten = 0;  // audio thread
+    juce::int64 numSamplesRead = 0;     // analysis thread
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisWorker)
+};
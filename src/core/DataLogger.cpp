@@ -0,0 +1,170 @@
+#include "DataLogger.h"
+
+//==============================================================================
+DataPoint DataPoint::fromFrame(const AnalysisFrame& frame, int stream, double timestamp, double hostTime) noexcept
+{
+    DataPoint point;
+    point.timestamp = timestamp;
+    point.hostTime = hostTime;
+    point.stream = stream;
+    point.activationScore = frame.acousticActivationScore;
+    point.spectralCentroid = frame.spectralCentroid;
+    point.spectralHarshness = frame.spectralHarshness;
+    point.dynamicVariability = frame.dynamicVariability;
+    point.temporalUnpredictability = frame.temporalUnpredictability;
+    point.rmsLevel = frame.rmsLevel;
+    point.spectralSpread = frame.spectralSpread;
+    point.spectralRolloff = frame.spectralRolloff;
+    point.spectralFlatness = frame.spectralFlatness;
+    point.spectralEntropy = frame.spectralEntropy;
+    point.sharpness = frame.sharpness;
+    point.roughness = frame.roughness;
+    point.loudnessSones = frame.loudnessSones;
+    point.loudnessPhons = frame.loudnessPhons;
+    point.loudnessN5 = frame.loudnessN5;
+    point.loudnessN10 = frame.loudnessN10;
+    point.tonalFrequency = frame.tonalFrequency;
+    point.toneToNoiseRatio = frame.toneToNoiseRatio;
+    point.prominenceRatio = frame.prominenceRatio;
+    point.numTonalComponents = frame.numTonalComponents;
+    point.momentaryLoudness = frame.momentaryLoudness;
+    point.shortTermLoudness = frame.shortTermLoudness;
+    point.integratedLoudness = frame.integratedLoudness;
+    point.loudnessRange = frame.loudnessRange;
+    point.aWeightedLeq = frame.aWeightedLeq;
+    point.cWeightedLeq = frame.cWeightedLeq;
+    point.zWeightedLeq = frame.zWeightedLeq;
+    point.aWeightedLevels = frame.aWeightedLevels;
+    point.aWeightedMaxLevels = frame.aWeightedMaxLevels;
+    point.dynamicVariabilityByTimescale = frame.dynamicVariabilityByTimescale;
+    point.temporalUnpredictabilityByTimescale = frame.temporalUnpredictabilityByTimescale;
+    point.cWeightedPeak = frame.cWeightedPeak;
+    point.zWeightedPeak = frame.zWeightedPeak;
+    point.thirdOctaveLevels = frame.thirdOctaveLevels;
+    point.octaveLevels = frame.octaveLevels;
+    point.mfcc = frame.mfcc;
+    return point;
+}
+
+const juce::StringArray& DataPoint::getLeqColumnNames()
+{
+    static const auto names = SoundLevelMeter::getEquivalentLevelNames(AcousticAnalysisEngine::getSoundLevelOptions());
+    return names;
+}
+
+const juce::StringArray& DataPoint::getTimescaleColumnNames()
+{
+    static const auto names = []
+        {
+            const auto timescales = DynamicsAnalyzer::getTimescaleNames(AcousticAnalysisEngine::getDynamicsOptions());
+            juce::StringArray columns;
+
+            for (auto prefix : { "Dynamic_Variability_", "Temporal_Unpredictability_" })
+                for (auto& timescale : timescales)
+                    columns.add(prefix + timescale);
+
+            return columns;
+        }();
+
+    return names;
+}
+
+//==============================================================================
+DataLogger::DataLogger()
+    : juce::Thread("Data Logger"),
+    ring((size_t)ringSize)
+{
+    startThread();
+}
+
+DataLogger::~DataLogger()
+{
+    stopThread(1000);
+}
+
+void DataLogger::clear()
+{
+    const juce::ScopedLock lock(storageLock);
+
+    // Throw away anything left over from the previous session
+    fifo.finishedRead(fifo.getNumReady());
+
+    chunks.clear();
+    numPoints.store(0, std::memory_order_release);
+    numDropped.store(0, std::memory_order_relaxed);
+    sessionStartMillis.store(0);
+}
+
+bool DataLogger::push(const DataPoint& point) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 + size2 < 1)
+    {
+        numDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    ring[(size_t)(size1 > 0 ? start1 : start2)] = point;
+    fifo.finishedWrite(1);
+    return true;
+}
+
+void DataLogger::flush()
+{
+    const juce::ScopedLock lock(storageLock);
+    drainRing();
+}
+
+DataLogger::Snapshot DataLogger::createSnapshot() const
+{
+    const juce::ScopedLock lock(storageLock);
+
+    Snapshot snapshot;
+    snapshot.chunks.assign(chunks.begin(), chunks.end());
+    snapshot.numPoints = numPoints.load(std::memory_order_relaxed);
+    snapshot.sessionStartMillis = sessionStartMillis.load();
+    return snapshot;
+}
+
+void DataLogger::run()
+{
+    while (!threadShouldExit())
+    {
+        {
+            const juce::ScopedLock lock(storageLock);
+            drainRing();
+        }
+
+        wait(drainIntervalMs);
+    }
+}
+
+void DataLogger::drainRing()
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+    auto stored = numPoints.load(std::memory_order_relaxed);
+
+    auto append = [this, &stored](int start, int count)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                const auto indexInChunk = stored % chunkSize;
+
+                if (indexInChunk == 0 && stored / chunkSize >= (int)chunks.size())
+                    chunks.push_back(std::make_shared<Chunk>());
+
+                (*chunks[(size_t)(stored / chunkSize)])[(size_t)indexInChunk] = ring[(size_t)(start + i)];
+                ++stored;
+            }
+        };
+
+    append(start1, size1);
+    append(start2, size2);
+
+    fifo.finishedRead(size1 + size2);
+    numPoints.store(stored, std::memory_order_release);
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "AcousticAnalysisEngine.h"
+#include "OctaveBandAnalyzer.h"
+#include <array>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+struct DataPoint
+{
+    double timestamp;           // seconds since the session started, from the sample count
+    double hostTime;            // seconds on the host timeline, NaN while the transport isn't playing
+    int stream;                 // analysis stream: input channels first, then mid, side and sum
+    float activationScore;
+    float spectralCentroid;
+    float spectralHarshness;
+    float dynamicVariability;
+    float temporalUnpredictability;
+    float rmsLevel;
+    float spectralSpread;
+    float spectralRolloff;
+    float spectralFlatness;
+    float spectralEntropy;
+    float sharpness;            // acum
+    float roughness;            // asper
+    float loudnessSones;        // Zwicker, after ISO 532-1
+    float loudnessPhons;
+    float loudnessN5;           // sone
+    float loudnessN10;          // sone
+    float tonalFrequency;       // Hz, most prominent tone, 0 without one
+    float toneToNoiseRatio;     // dB, ECMA-418-1
+    float prominenceRatio;      // dB, ECMA-418-1
+    int numTonalComponents;
+    float momentaryLoudness;    // LUFS
+    float shortTermLoudness;    // LUFS
+    float integratedLoudness;   // LUFS
+    float loudnessRange;        // LU
+    std::array<float, SoundLevelMeter::numPeriods> aWeightedLeq;   // dB re full scale, one per SoundLevelMeter period
+    std::array<float, SoundLevelMeter::numPeriods> cWeightedLeq;
+    std::array<float, SoundLevelMeter::numPeriods> zWeightedLeq;
+    std::array<float, 3> aWeightedLevels;      // LAF, LAS, LAI
+    std::array<float, 3> aWeightedMaxLevels;   // LAFmax, LASmax, LAImax
+    std::array<float, DynamicsAnalyzer::numTimescales> dynamicVariabilityByTimescale;     // one per DynamicsAnalyzer timescale
+    std::array<float, DynamicsAnalyzer::numTimescales> temporalUnpredictabilityByTimescale;
+    float cWeightedPeak;        // LCpeak
+    float zWeightedPeak;        // LZpeak
+    std::array<float, OctaveBandAnalyzer::numThirdOctaveBands> thirdOctaveLevels;  // dB re full-scale RMS, 20 Hz to 20 kHz
+    std::array<float, OctaveBandAnalyzer::numOctaveBands> octaveLevels;            // 31.5 Hz to 16 kHz
+    std::array<float, AnalysisFrame::numMFCCs> mfcc;                               // perceptual filterbank cepstrum
+
+    /**
+        The point logged for one stream of an analysis frame. The plugin and the batch tool
+        both log through this, so their sessions match frame for frame.
+    */
+    static DataPoint fromFrame(const AnalysisFrame& frame, int stream, double timestamp,
+                               double hostTime = std::numeric_limits<double>::quiet_NaN()) noexcept;
+
+    /**
+        Column names of aWeightedLeq, cWeightedLeq and zWeightedLeq in that order, from the
+        periods the engines are prepared with. Built once, shared by every exporter.
+    */
+    static const juce::StringArray& getLeqColumnNames();
+
+    /** Column names of dynamicVariabilityByTimescale, then temporalUnpredictabilityByTimescale. */
+    static const juce::StringArray& getTimescaleColumnNames();
+};
+
+//==============================================================================
+/**
+    Session log that can be written from a real-time thread.
+
+    push() only copies the point into a preallocated single-producer/single-consumer
+    ring, so it never locks or allocates. A background thread drains the ring into
+    fixed-size chunks that are appended but never moved, which means a long session
+    grows without ever reallocating what has already been stored.
+*/
+class DataLogger : private juce::Thread
+{
+public:
+    DataLogger();
+    ~DataLogger() override;
+
+    /** Discards the previous session. Call while no one is pushing. */
+    void clear();
+
+    /** Wall-clock time at which the current session started, carried into snapshots for export. */
+    void setSessionStartTime(juce::Time startTime) noexcept { sessionStartMillis.store(startTime.toMilliseconds()); }
+
+    /** Single producer only (the analysis thread). Returns false if the ring was full and the point was dropped. */
+    bool push(const DataPoint& point) noexcept;
+
+    /** Moves anything still waiting in the ring into storage. */
+    void flush();
+
+    /** Number of points that have reached storage. */
+    int getNumPoints() const noexcept { return numPoints.load(std::memory_order_acquire); }
+
+    /** Number of points lost because the consumer fell behind. */
+    int getNumDroppedPoints() const noexcept { return numDropped.load(std::memory_order_relaxed); }
+
+    static constexpr int chunkSize = 4096;
+    using Chunk = std::array<DataPoint, (size_t)chunkSize>;
+
+    /**
+        A frozen view of the log. Only the chunk pointers are copied, so taking one is
+        cheap, and the chunks stay alive even if the logger is cleared afterwards.
+    */
+    struct Snapshot
+    {
+        std::vector<std::shared_ptr<const Chunk>> chunks;
+        int numPoints = 0;
+        juce::int64 sessionStartMillis = 0;     // UTC, milliseconds since 1970; 0 if unknown
+
+        const DataPoint& operator[](int index) const noexcept
+        {
+            return (*chunks[(size_t)(index / chunkSize)])[(size_t)(index % chunkSize)];
+        }
+
+        template <typename Fn>
+        void forEachPoint(Fn&& fn) const
+        {
+            auto remaining = numPoints;
+
+            for (const auto& chunk : chunks)
+            {
+                const auto count = juce::jmin(remaining, chunkSize);
+
+                for (int i = 0; i < count; ++i)
+                    fn((*chunk)[(size_t)i]);
+
+                remaining -= count;
+            }
+        }
+    };
+
+    /** Blocks only the consumer briefly, never the producer. */
+    Snapshot createSnapshot() const;
+
+private:
+    void run() override;
+    void drainRing();
+
+    static constexpr int ringSize = 8192;    // several minutes of frames
+    static constexpr int drainIntervalMs = 50;
+
+    juce::AbstractFifo fifo{ ringSize };
+    std::vector<DataPoint> ring;
+
+    // The consumer side of the ring and the chunk list are shared between the drain
+    // thread and readers on the message thread; the audio thread never touches them.
+    // Slots below numPoints are never written again, so snapshots can read them unlocked.
+    juce::CriticalSection storageLock;
+    std::vector<std::shared_ptr<Chunk>> chunks;
+
+    std::atomic<int> numPoints{ 0 };
+    std::atomic<int> numDropped{ 0 };
+    std::atomic<juce::int64> sessionStartMillis{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DataLogger)
+};
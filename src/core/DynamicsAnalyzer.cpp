@@ -0,0 +1,71 @@
+#include "DynamicsAnalyzer.h"
+
+namespace
+{
+    // The scales the activation score was tuned with: standard deviation x 20, and a change
+    // of the RMS x 50 per 25 ms hop, i.e. x 1.25 per second
+    constexpr float variabilityScale = 20.0f;
+    constexpr float unpredictabilityScale = 50.0f / 40.0f;
+}
+
+//==============================================================================
+juce::StringArray DynamicsAnalyzer::getTimescaleNames(const Options& options)
+{
+    juce::StringArray names;
+
+    for (auto seconds : options.timescales)
+    {
+        const auto useMinutes = seconds >= 60.0;
+        const auto value = useMinutes ? seconds / 60.0 : seconds;
+        names.add(juce::String(value, value == std::floor(value) ? 0 : 1) + (useMinutes ? "min" : "s"));
+    }
+
+    return names;
+}
+
+void DynamicsAnalyzer::prepare(double sampleRate, const Options& optionsToUse)
+{
+    options = optionsToUse;
+    envelope.prepare(sampleRate);
+
+    const auto frameRate = envelope.getFrameRate();
+    std::array<int, numTimescales + 1> lengths{};
+    lengths[0] = juce::roundToInt(options.scoreWindow * frameRate);
+
+    for (int i = 0; i < numTimescales; ++i)
+        lengths[(size_t)i + 1] = juce::roundToInt(options.timescales[(size_t)i] * frameRate);
+
+    statistics.prepare(lengths.data(), static_cast<int>(lengths.size()));
+
+    reset();
+}
+
+void DynamicsAnalyzer::reset() noexcept
+{
+    envelope.reset();
+    statistics.reset();
+    numFramesRead = 0;
+}
+
+void DynamicsAnalyzer::process(const float* samples, int numSamples) noexcept
+{
+    // At most one envelope frame per run, so none leaves the envelope's history unread
+    for (int offset = 0; offset < numSamples; offset += envelope.getFrameLength())
+    {
+        envelope.process(samples + offset, juce::jmin(envelope.getFrameLength(), numSamples - offset));
+
+        for (; numFramesRead < envelope.getNumFramesCompleted(); ++numFramesRead)
+            statistics.add(envelope.getCompletedFrame(numFramesRead));
+    }
+}
+
+float DynamicsAnalyzer::getVariabilityOfWindow(int window) const noexcept
+{
+    return juce::jlimit(0.0f, 1.0f, static_cast<float>(statistics.getStandardDeviation(window)) * variabilityScale);
+}
+
+float DynamicsAnalyzer::getUnpredictabilityOfWindow(int window) const noexcept
+{
+    const auto changePerSecond = statistics.getMeanAbsoluteDifference(window) * envelope.getFrameRate();
+    return juce::jlimit(0.0f, 1.0f, static_cast<float>(changePerSecond) * unpredictabilityScale);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "RMSEnvelope.h"
+#include "SlidingStatistics.h"
+#include <array>
+
+//==============================================================================
+/**
+    Level dynamics over several timescales, from a fixed-rate 10 ms RMSEnvelope:
+    variability (the standard deviation of the envelope) and unpredictability (the mean
+    change between consecutive envelope frames), each over a trailing window and scaled
+    to 0-1.
+
+    The window behind the activation score (2.5 s) and the reported timescales (1 s,
+    10 s, 1 min and 10 min by default) are all windows of one SlidingStatistics, so an
+    envelope frame costs O(1) per window and reading any of them is O(1), however long
+    the window. Nothing allocates after prepare().
+*/
+class DynamicsAnalyzer
+{
+public:
+    static constexpr int numTimescales = 4;
+
+    struct Options
+    {
+        double scoreWindow = 2.5;       // seconds, for getVariability() and getUnpredictability()
+        std::array<double, numTimescales> timescales{ 1.0, 10.0, 60.0, 600.0 };
+    };
+
+    DynamicsAnalyzer() = default;
+
+    /** Allocates the envelope and the windows. Not real-time safe. */
+    void prepare(double sampleRate, const Options& optionsToUse);
+    void prepare(double sampleRate) { prepare(sampleRate, Options()); }
+
+    void reset() noexcept;
+
+    /** Feeds a block of any size. Real-time safe. */
+    void process(const float* samples, int numSamples) noexcept;
+
+    /** 0-1, over the score window. */
+    float getVariability() const noexcept { return getVariabilityOfWindow(0); }
+    float getUnpredictability() const noexcept { return getUnpredictabilityOfWindow(0); }
+
+    /** 0-1, over one of Options::timescales. */
+    float getVariability(int timescale) const noexcept { return getVariabilityOfWindow(timescale + 1); }
+    float getUnpredictability(int timescale) const noexcept { return getUnpredictabilityOfWindow(timescale + 1); }
+
+    const RMSEnvelope& getEnvelope() const noexcept { return envelope; }
+    const Options& getOptions() const noexcept { return options; }
+
+    /** "1s", "10s", "1min", "10min"... one per timescale of the options. */
+    static juce::StringArray getTimescaleNames(const Options& options);
+
+private:
+    float getVariabilityOfWindow(int window) const noexcept;
+    float getUnpredictabilityOfWindow(int window) const noexcept;
+
+    Options options;
+    RMSEnvelope envelope;
+    SlidingStatistics statistics;       // window 0 is the score window, then the timescales
+    juce::int64 numFramesRead = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DynamicsAnalyzer)
+};
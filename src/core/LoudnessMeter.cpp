@@ -0,0 +1,290 @@
+#include "LoudnessMeter.h"
+
+//==============================================================================
+void LoudnessMeter::Histogram::clear() noexcept
+{
+    counts.fill(0);
+    energies.fill(0.0);
+    total = 0;
+    totalEnergy = 0.0;
+}
+
+void LoudnessMeter::Histogram::add(double energy, double loudness) noexcept
+{
+    const auto bin = (size_t)getHistogramBin(loudness);
+    ++counts[bin];
+    energies[bin] += energy;
+    ++total;
+    totalEnergy += energy;
+}
+
+double LoudnessMeter::energyToLoudness(double energy) noexcept
+{
+    return energy > 0.0 ? juce::jmax(static_cast<double>(minimumLoudness), -0.691 + 10.0 * std::log10(energy))
+                        : static_cast<double>(minimumLoudness);
+}
+
+int LoudnessMeter::getHistogramBin(double loudness) noexcept
+{
+    return juce::jlimit(0, histogramSize - 1, static_cast<int>((loudness - histogramMin) / histogramStep));
+}
+
+double LoudnessMeter::getHistogramBinLoudness(int bin) noexcept
+{
+    return histogramMin + (bin + 0.5) * histogramStep;
+}
+
+//==============================================================================
+void LoudnessMeter::prepare(double sampleRate, int numChannels)
+{
+    // K-weighting stage 1: high shelf modelling the head, +4 dB above ~1.7 kHz
+    {
+        const auto k = std::tan(juce::MathConstants<double>::pi * 1681.974450955533 / sampleRate);
+        const auto q = 0.7071752369554196;
+        const auto vh = std::pow(10.0, 3.999843853973347 / 20.0);
+        const auto vb = std::pow(vh, 0.4996667741545416);
+        const auto a0 = 1.0 + k / q + k * k;
+
+        shelf.b0 = (vh + vb * k / q + k * k) / a0;
+        shelf.b1 = 2.0 * (k * k - vh) / a0;
+        shelf.b2 = (vh - vb * k / q + k * k) / a0;
+        shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+        shelf.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    // Stage 2: the RLB high-pass at ~38 Hz
+    {
+        const auto k = std::tan(juce::MathConstants<double>::pi * 38.13547087602444 / sampleRate);
+        const auto q = 0.5003270373238773;
+        const auto a0 = 1.0 + k / q + k * k;
+
+        highPass.b0 = 1.0;
+        highPass.b1 = -2.0;
+        highPass.b2 = 1.0;
+        highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+        highPass.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    subBlockSize = juce::jmax(1, juce::roundToInt(sampleRate * 0.1));
+    channels.assign((size_t)juce::jmax(1, numChannels), {});
+
+    reset();
+}
+
+void LoudnessMeter::reset()
+{
+    for (auto& channel : channels)
+        channel.s1 = channel.s2 = channel.s3 = channel.s4 = 0.0;
+
+    subBlockFill = 0;
+    subBlockEnergy = 0.0;
+
+    subBlocks.fill(0.0);
+    subBlockPos = 0;
+    numSubBlocks = 0;
+    momentarySum = 0.0;
+    shortTermSum = 0.0;
+
+    momentaryLoudness = minimumLoudness;
+    shortTermLoudness = minimumLoudness;
+
+    resetIntegration();
+}
+
+void LoudnessMeter::resetIntegration() noexcept
+{
+    momentaryHistogram.clear();
+    shortTermHistogram.clear();
+    integratedLoudness = minimumLoudness;
+    loudnessRange = 0.0f;
+}
+
+void LoudnessMeter::setChannelWeight(int channel, float weight)
+{
+    if (juce::isPositiveAndBelow(channel, static_cast<int>(channels.size())))
+        channels[(size_t)channel].weight = weight;
+}
+
+float LoudnessMeter::getChannelWeight(juce::AudioChannelSet::ChannelType type) noexcept
+{
+    switch (type)
+    {
+        case juce::AudioChannelSet::LFE:
+        case juce::AudioChannelSet::LFE2:
+            return 0.0f;
+
+        case juce::AudioChannelSet::leftSurround:
+        case juce::AudioChannelSet::rightSurround:
+        case juce::AudioChannelSet::leftSurroundSide:
+        case juce::AudioChannelSet::rightSurroundSide:
+        case juce::AudioChannelSet::leftSurroundRear:
+        case juce::AudioChannelSet::rightSurroundRear:
+            return 1.41f;
+
+        default:
+            return 1.0f;
+    }
+}
+
+//==============================================================================
+void LoudnessMeter::process(const float* const* inputs, int numInputs, int numSamples) noexcept
+{
+    const auto numChannels = juce::jmin(numInputs, static_cast<int>(channels.size()));
+    int offset = 0;
+
+    while (offset < numSamples)
+    {
+        const auto count = juce::jmin(numSamples - offset, subBlockSize - subBlockFill);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& channel = channels[(size_t)ch];
+
+            if (channel.weight != 0.0f && inputs[ch] != nullptr)
+                subBlockEnergy += channel.weight * filterChannel(channel, inputs[ch] + offset, count);
+        }
+
+        offset += count;
+        subBlockFill += count;
+
+        if (subBlockFill == subBlockSize)
+            finishSubBlock();
+    }
+}
+
+double LoudnessMeter::filterChannel(ChannelState& state, const float* samples, int numSamples) const noexcept
+{
+    auto s1 = state.s1, s2 = state.s2, s3 = state.s3, s4 = state.s4;
+    double sumOfSquares = 0.0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto x = static_cast<double>(samples[i]);
+
+        const auto y = shelf.b0 * x + s1;
+        s1 = shelf.b1 * x - shelf.a1 * y + s2;
+        s2 = shelf.b2 * x - shelf.a2 * y;
+
+        const auto z = highPass.b0 * y + s3;
+        s3 = highPass.b1 * y - highPass.a1 * z + s4;
+        s4 = highPass.b2 * y - highPass.a2 * z;
+
+        sumOfSquares += z * z;
+    }
+
+    state.s1 = s1; state.s2 = s2; state.s3 = s3; state.s4 = s4;
+    return sumOfSquares;
+}
+
+void LoudnessMeter::finishSubBlock() noexcept
+{
+    const auto energy = subBlockEnergy / subBlockSize;
+    subBlockEnergy = 0.0;
+    subBlockFill = 0;
+
+    // Slide both windows by one sub-block: add the new one, drop the one leaving each window
+    const auto leavingMomentary = subBlocks[(size_t)((subBlockPos + shortTermBlocks - momentaryBlocks) % shortTermBlocks)];
+    const auto leavingShortTerm = subBlocks[(size_t)subBlockPos];
+
+    momentarySum += energy - leavingMomentary;
+    shortTermSum += energy - leavingShortTerm;
+
+    subBlocks[(size_t)subBlockPos] = energy;
+    subBlockPos = (subBlockPos + 1) % shortTermBlocks;
+    ++numSubBlocks;
+
+    // Re-sum once per lap so rounding in the running sums can't accumulate
+    if (subBlockPos == 0)
+    {
+        shortTermSum = 0.0;
+        for (auto e : subBlocks)
+            shortTermSum += e;
+
+        momentarySum = 0.0;
+        for (int i = shortTermBlocks - momentaryBlocks; i < shortTermBlocks; ++i)
+            momentarySum += subBlocks[(size_t)i];
+    }
+
+    const auto momentaryEnergy = juce::jmax(0.0, momentarySum) / momentaryBlocks;
+    const auto shortTermEnergy = juce::jmax(0.0, shortTermSum) / shortTermBlocks;
+    const auto momentary = energyToLoudness(momentaryEnergy);
+    const auto shortTerm = energyToLoudness(shortTermEnergy);
+
+    momentaryLoudness = static_cast<float>(momentary);
+    shortTermLoudness = static_cast<float>(shortTerm);
+
+    // Only complete windows take part in gating
+    if (numSubBlocks >= momentaryBlocks && momentary >= absoluteGate)
+    {
+        momentaryHistogram.add(momentaryEnergy, momentary);
+        updateIntegratedLoudness();
+    }
+
+    if (numSubBlocks >= shortTermBlocks && shortTerm >= absoluteGate)
+    {
+        shortTermHistogram.add(shortTermEnergy, shortTerm);
+        updateLoudnessRange();
+    }
+}
+
+void LoudnessMeter::updateIntegratedLoudness() noexcept
+{
+    // Everything in the histogram already passed the absolute gate
+    const auto& histogram = momentaryHistogram;
+    const auto threshold = energyToLoudness(histogram.totalEnergy / static_cast<double>(histogram.total)) + integratedRelativeGate;
+
+    double energy = 0.0;
+    juce::uint64 count = 0;
+
+    for (auto bin = getHistogramBin(threshold); bin < histogramSize; ++bin)
+    {
+        energy += histogram.energies[(size_t)bin];
+        count += histogram.counts[(size_t)bin];
+    }
+
+    integratedLoudness = count > 0 ? static_cast<float>(energyToLoudness(energy / static_cast<double>(count)))
+                                   : minimumLoudness;
+}
+
+void LoudnessMeter::updateLoudnessRange() noexcept
+{
+    const auto& histogram = shortTermHistogram;
+    const auto threshold = energyToLoudness(histogram.totalEnergy / static_cast<double>(histogram.total)) + rangeRelativeGate;
+    const auto firstBin = getHistogramBin(threshold);
+
+    juce::uint64 count = 0;
+    for (auto bin = firstBin; bin < histogramSize; ++bin)
+        count += histogram.counts[(size_t)bin];
+
+    if (count == 0)
+    {
+        loudnessRange = 0.0f;
+        return;
+    }
+
+    // 10th and 95th percentiles of the gated short-term loudness distribution
+    const auto lowRank = static_cast<double>(count) * 0.10;
+    const auto highRank = static_cast<double>(count) * 0.95;
+    double low = 0.0, high = 0.0;
+    juce::uint64 cumulative = 0;
+    bool foundLow = false;
+
+    for (auto bin = firstBin; bin < histogramSize; ++bin)
+    {
+        cumulative += histogram.counts[(size_t)bin];
+
+        if (!foundLow && static_cast<double>(cumulative) > lowRank)
+        {
+            low = getHistogramBinLoudness(bin);
+            foundLow = true;
+        }
+
+        if (static_cast<double>(cumulative) >= highRank)
+        {
+            high = getHistogramBinLoudness(bin);
+            break;
+        }
+    }
+
+    loudnessRange = static_cast<float>(juce::jmax(0.0, high - low));
+}
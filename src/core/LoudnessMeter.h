@@ -0,0 +1,119 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <vector>
+
+//==============================================================================
+/**
+    ITU-R BS.1770-4 / EBU R128 loudness of a multichannel signal: momentary (400 ms),
+    short-term (3 s), gated integrated loudness and loudness range (EBU Tech 3342).
+
+    Every channel goes through the two K-weighting biquads, whose coefficients are
+    derived for the actual sample rate. Weighted mean squares are summed per 100 ms
+    sub-block; the sliding windows keep running sums over a ring of sub-blocks, so each
+    sub-block costs O(1) whatever the window length.
+
+    Gating needs the loudness of every block since the start of the measurement. Rather
+    than storing them, blocks are counted in fixed 0.1 LU histograms (energy sum and
+    count per bin), so memory stays constant over arbitrarily long sessions and the
+    gated values are exact to within one bin. Nothing allocates after prepare().
+*/
+class LoudnessMeter
+{
+public:
+    /** Reported for silence and anything quieter, so logs never contain -inf. */
+    static constexpr float minimumLoudness = -100.0f;
+
+    LoudnessMeter() = default;
+
+    /** Allocates and resets. Every channel weight returns to 1. */
+    void prepare(double sampleRate, int numChannels);
+
+    /** Clears the filters, windows and gated measurements. */
+    void reset();
+
+    /** Restarts integrated loudness and loudness range without touching the sliding windows. */
+    void resetIntegration() noexcept;
+
+    /** BS.1770 channel weight G: 1 for front channels, 1.41 for surrounds, 0 to exclude (LFE). */
+    void setChannelWeight(int channel, float weight);
+
+    /** The BS.1770-4 weight of a channel of a layout: surrounds count 1.41, the LFE not at all. */
+    static float getChannelWeight(juce::AudioChannelSet::ChannelType type) noexcept;
+
+    /** Feeds one block per channel. Channels beyond the prepared count are ignored. Real-time safe. */
+    void process(const float* const* channels, int numChannels, int numSamples) noexcept;
+
+    float getMomentaryLoudness() const noexcept { return momentaryLoudness; }     // LUFS
+    float getShortTermLoudness() const noexcept { return shortTermLoudness; }     // LUFS
+    float getIntegratedLoudness() const noexcept { return integratedLoudness; }   // LUFS
+    float getLoudnessRange() const noexcept { return loudnessRange; }             // LU
+
+private:
+    static constexpr int momentaryBlocks = 4;       // 400 ms
+    static constexpr int shortTermBlocks = 30;      // 3 s
+    static constexpr double absoluteGate = -70.0;
+    static constexpr double integratedRelativeGate = -10.0;
+    static constexpr double rangeRelativeGate = -20.0;
+
+    static constexpr double histogramMin = absoluteGate;
+    static constexpr double histogramStep = 0.1;
+    static constexpr int histogramSize = 800;       // -70 to +10 LUFS
+
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    };
+
+    struct ChannelState
+    {
+        double s1 = 0.0, s2 = 0.0;      // shelving stage, transposed direct form II
+        double s3 = 0.0, s4 = 0.0;      // high-pass stage
+        float weight = 1.0f;
+    };
+
+    struct Histogram
+    {
+        std::array<juce::uint32, histogramSize> counts{};
+        std::array<double, histogramSize> energies{};
+        juce::uint64 total = 0;
+        double totalEnergy = 0.0;
+
+        void clear() noexcept;
+        void add(double energy, double loudness) noexcept;
+    };
+
+    static double energyToLoudness(double energy) noexcept;
+    static int getHistogramBin(double loudness) noexcept;
+    static double getHistogramBinLoudness(int bin) noexcept;
+
+    double filterChannel(ChannelState& state, const float* samples, int numSamples) const noexcept;
+    void finishSubBlock() noexcept;
+    void updateIntegratedLoudness() noexcept;
+    void updateLoudnessRange() noexcept;
+
+    Biquad shelf, highPass;
+    std::vector<ChannelState> channels;
+
+    int subBlockSize = 4410;
+    int subBlockFill = 0;
+    double subBlockEnergy = 0.0;
+
+    // Ring of the last shortTermBlocks sub-block energies, with running sums over both windows
+    std::array<double, shortTermBlocks> subBlocks{};
+    int subBlockPos = 0;
+    juce::int64 numSubBlocks = 0;
+    double momentarySum = 0.0;
+    double shortTermSum = 0.0;
+
+    Histogram momentaryHistogram;   // 400 ms gating blocks, 75 % overlap
+    Histogram shortTermHistogram;   // 3 s blocks every 100 ms, for the loudness range
+
+    float momentaryLoudness = minimumLoudness;
+    float shortTermLoudness = minimumLoudness;
+    float integratedLoudness = minimumLoudness;
+    float loudnessRange = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessMeter)
+};
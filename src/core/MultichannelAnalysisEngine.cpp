@@ -0,0 +1,147 @@
+#include "MultichannelAnalysisEngine.h"
+
+//==============================================================================
+MultichannelAnalysisEngine::MultichannelAnalysisEngine()
+{
+    prepare(currentSampleRate, 1, {});
+}
+
+void MultichannelAnalysisEngine::prepare(double sampleRate, int numChannels, Options optionsToUse)
+{
+    currentSampleRate = sampleRate;
+    numInputChannels = juce::jmax(1, numChannels);
+    options = optionsToUse;
+
+    // Derived views only where they mean something
+    auto numStreams = numInputChannels;
+    midStream = sideStream = sumStream = -1;
+
+    if (options.includeMidSide && numInputChannels == 2)
+    {
+        midStream = numStreams++;
+        sideStream = numStreams++;
+    }
+
+    if (options.includeSum && numInputChannels > 1)
+        sumStream = numStreams++;
+
+    engines.clear();
+
+    for (int i = 0; i < numStreams; ++i)
+    {
+        engines.push_back(std::make_unique<AcousticAnalysisEngine>());
+        engines.back()->prepare(sampleRate, options.filterbank);
+        engines.back()->setHopSize(hopSize);
+        engines.back()->setUsePsychoacousticHarshness(options.psychoacousticHarshness);
+        engines.back()->setFullScaleLevel(options.fullScaleLevel);
+    }
+
+    loudness.prepare(sampleRate, numInputChannels);
+    loudnessInputs.assign((size_t)numInputChannels, nullptr);
+    chunkStartSample = 0;
+
+    scratch.assign((size_t)numStreams * maxChunkSize, 0.0f);
+    pendingFrames.resize((size_t)numStreams);
+    hopFrames.resize((size_t)numStreams);
+    reservePendingFrames();
+}
+
+void MultichannelAnalysisEngine::reset()
+{
+    for (auto& engine : engines)
+        engine->reset();
+
+    loudness.reset();
+    chunkStartSample = 0;
+}
+
+void MultichannelAnalysisEngine::setHopSize(int newHopSize)
+{
+    for (auto& engine : engines)
+        engine->setHopSize(newHopSize);
+
+    hopSize = engines.empty() ? newHopSize : engines.front()->getHopSize();
+    reservePendingFrames();
+}
+
+void MultichannelAnalysisEngine::setFullScaleLevel(float newLevel) noexcept
+{
+    options.fullScaleLevel = newLevel;
+
+    for (auto& engine : engines)
+        engine->setFullScaleLevel(newLevel);
+}
+
+void MultichannelAnalysisEngine::reservePendingFrames()
+{
+    // Enough for every hop a chunk can complete, so process() never allocates
+    const auto maxFramesPerChunk = (size_t)(maxChunkSize / hopSize + 1);
+
+    for (auto& frames : pendingFrames)
+        frames.reserve(maxFramesPerChunk);
+
+    pendingSpectra.resize(maxFramesPerChunk * (size_t)getNumBins());
+}
+
+void MultichannelAnalysisEngine::processLoudness(int startInChunk, int endInChunk) noexcept
+{
+    if (endInChunk <= startInChunk)
+        return;
+
+    for (int ch = 0; ch < numInputChannels; ++ch)
+        loudnessInputs[(size_t)ch] = getStreamData(ch) + startInChunk;
+
+    loudness.process(loudnessInputs.data(), numInputChannels, endInChunk - startInChunk);
+}
+
+juce::String MultichannelAnalysisEngine::getStreamName(int stream) const
+{
+    if (stream == midStream)  return "Mid";
+    if (stream == sideStream) return "Side";
+    if (stream == sumStream)  return "Sum";
+
+    return "Ch " + juce::String(stream + 1);
+}
+
+void MultichannelAnalysisEngine::loadChunk(const float* const* channels, int numChannels, int offset, int numSamples) noexcept
+{
+    // Gather the channels into their lanes
+    for (int ch = 0; ch < numInputChannels; ++ch)
+    {
+        auto* lane = scratch.data() + (size_t)ch * maxChunkSize;
+
+        if (ch < numChannels && channels[ch] != nullptr)
+            juce::FloatVectorOperations::copy(lane, channels[ch] + offset, numSamples);
+        else
+            juce::FloatVectorOperations::clear(lane, numSamples);
+    }
+
+    auto* left = scratch.data();
+    auto* right = scratch.data() + maxChunkSize;
+
+    if (midStream >= 0)
+    {
+        auto* mid = scratch.data() + (size_t)midStream * maxChunkSize;
+        juce::FloatVectorOperations::add(mid, left, right, numSamples);
+        juce::FloatVectorOperations::multiply(mid, 0.5f, numSamples);
+    }
+
+    if (sideStream >= 0)
+    {
+        auto* side = scratch.data() + (size_t)sideStream * maxChunkSize;
+        juce::FloatVectorOperations::subtract(side, left, right, numSamples);
+        juce::FloatVectorOperations::multiply(side, 0.5f, numSamples);
+    }
+
+    if (sumStream >= 0)
+    {
+        // Averaged rather than summed so levels stay comparable with a single channel
+        auto* sum = scratch.data() + (size_t)sumStream * maxChunkSize;
+        juce::FloatVectorOperations::copy(sum, left, numSamples);
+
+        for (int ch = 1; ch < numInputChannels; ++ch)
+            juce::FloatVectorOperations::add(sum, scratch.data() + (size_t)ch * maxChunkSize, numSamples);
+
+        juce::FloatVectorOperations::multiply(sum, 1.0f / static_cast<float>(numInputChannels), numSamples);
+    }
+}
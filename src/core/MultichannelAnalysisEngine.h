@@ -0,0 +1,181 @@
+#pragma once
+
+#include "AcousticAnalysisEngine.h"
+#include "LoudnessMeter.h"
+#include <memory>
+
+//==============================================================================
+/** One stream's frame as published to readers outside the analysis thread. */
+struct FeatureSnapshot
+{
+    AnalysisFrame frame;
+    int stream = 0;
+    int numStreams = 1;
+};
+
+//==============================================================================
+/**
+    Runs the analysis pipeline on every channel of a bus, plus optional derived views:
+    mid and side for stereo input, and the average of all channels.
+
+    Each of these is an analysis stream with its own AcousticAnalysisEngine. Channels come
+    first, in bus order, followed by mid, side and sum when enabled. Incoming channels and
+    derived views share one structure-of-arrays scratch block, so the views are built
+    with a handful of vectorised operations per block rather than per sample.
+
+    All streams share a hop, so their frames complete at the same sample positions; the
+    callback receives one frame per stream for every hop.
+
+    The input channels are also measured together by a LoudnessMeter, advanced to each
+    frame's end before the frames are handed out, so every frame carries the programme
+    loudness at exactly its own position.
+*/
+class MultichannelAnalysisEngine
+{
+public:
+    struct Options
+    {
+        bool includeMidSide = false;    // stereo input only
+        bool includeSum = false;        // two or more channels only
+        PerceptualFilterbank::Options filterbank;   // shared by every stream
+        bool psychoacousticHarshness = false;       // score from sharpness and roughness
+        float fullScaleLevel = 100.0f;              // dB SPL of a full-scale RMS of 1
+    };
+
+    MultichannelAnalysisEngine();
+
+    /** Allocates and resets. Not real-time safe. */
+    void prepare(double sampleRate, int numChannels, Options options);
+    void reset();
+
+    void setHopSize(int newHopSize);
+    int getHopSize() const noexcept { return hopSize; }
+
+    /** Changes Options::fullScaleLevel of every stream without preparing again. */
+    void setFullScaleLevel(float newLevel) noexcept;
+    double getSampleRate() const noexcept { return currentSampleRate; }
+
+    int getNumChannels() const noexcept { return numInputChannels; }
+    int getNumStreams() const noexcept { return static_cast<int>(engines.size()); }
+    Options getOptions() const noexcept { return options; }
+
+    /** "Ch 1".."Ch n", then "Mid", "Side" and "Sum". */
+    juce::String getStreamName(int stream) const;
+
+    /** The engine of one stream, for its session-long measurements. */
+    const AcousticAnalysisEngine& getStreamEngine(int stream) const noexcept { return *engines[(size_t)stream]; }
+
+    /** Programme loudness of all input channels up to the last sample processed. */
+    const LoudnessMeter& getLoudnessMeter() const noexcept { return loudness; }
+
+    /** BS.1770 weight of an input channel (1.41 for surrounds, 0 for LFE). Call after prepare(). */
+    void setLoudnessChannelWeight(int channel, float weight) { loudness.setChannelWeight(channel, weight); }
+
+    /** Restarts integrated loudness and loudness range, e.g. when a recording starts. */
+    void resetLoudnessIntegration() noexcept { loudness.resetIntegration(); }
+
+    /** Restarts every stream's Leq intervals, time-weighted maxima, peaks and percentiles. */
+    void resetSession() noexcept
+    {
+        for (auto& engine : engines)
+            engine->resetSession();
+    }
+
+    /** The stream whose magnitude spectrum is passed to the process() callback. */
+    void setSpectrumStream(int stream) noexcept { spectrumStream = stream; }
+    int getNumBins() const noexcept { return AcousticAnalysisEngine::fftSize / 2; }
+
+    /**
+        Feeds one block per channel and calls
+        onFrames(const AnalysisFrame* frames, int numStreams, const float* spectrum)
+        for every hop completed inside it, where spectrum holds getNumBins() magnitudes of
+        the spectrum stream. Channels beyond numChannels are ignored; missing ones are
+        treated as silent.
+    */
+    template <typename FrameCallback>
+    void process(const float* const* channels, int numChannels, int numSamples, FrameCallback&& onFrames)
+    {
+        for (int offset = 0; offset < numSamples; offset += maxChunkSize)
+        {
+            const auto chunk = juce::jmin(numSamples - offset, maxChunkSize);
+
+            loadChunk(channels, numChannels, offset, chunk);
+
+            const auto spectrumIndex = (size_t)juce::jlimit(0, getNumStreams() - 1, spectrumStream);
+
+            for (size_t stream = 0; stream < engines.size(); ++stream)
+            {
+                auto& engine = *engines[stream];
+                auto& frames = pendingFrames[stream];
+                frames.clear();
+
+                engine.process(getStreamData(static_cast<int>(stream)), chunk, [&](const AnalysisFrame& frame)
+                    {
+                        if (stream == spectrumIndex)
+                            std::copy(engine.getMagnitudes(), engine.getMagnitudes() + getNumBins(),
+                                      pendingSpectra.begin() + (std::ptrdiff_t)(frames.size() * (size_t)getNumBins()));
+
+                        frames.push_back(frame);
+                    });
+            }
+
+            // Every stream completes the same number of frames per chunk
+            const auto numFrames = pendingFrames.empty() ? size_t(0) : pendingFrames.front().size();
+
+            int loudnessPos = 0;
+
+            for (size_t i = 0; i < numFrames; ++i)
+            {
+                const auto frameEnd = static_cast<int>(pendingFrames.front()[i].endSample - chunkStartSample);
+                processLoudness(loudnessPos, frameEnd);
+                loudnessPos = frameEnd;
+
+                for (size_t stream = 0; stream < engines.size(); ++stream)
+                {
+                    auto& frame = hopFrames[stream];
+                    frame = pendingFrames[stream][i];
+                    frame.momentaryLoudness = loudness.getMomentaryLoudness();
+                    frame.shortTermLoudness = loudness.getShortTermLoudness();
+                    frame.integratedLoudness = loudness.getIntegratedLoudness();
+                    frame.loudnessRange = loudness.getLoudnessRange();
+                }
+
+                onFrames(static_cast<const AnalysisFrame*>(hopFrames.data()), getNumStreams(),
+                         static_cast<const float*>(pendingSpectra.data() + i * (size_t)getNumBins()));
+            }
+
+            processLoudness(loudnessPos, chunk);
+            chunkStartSample += chunk;
+        }
+    }
+
+private:
+    static constexpr int maxChunkSize = 4096;
+
+    void loadChunk(const float* const* channels, int numChannels, int offset, int numSamples) noexcept;
+    const float* getStreamData(int stream) const noexcept { return scratch.data() + (size_t)stream * maxChunkSize; }
+    void reservePendingFrames();
+    void processLoudness(int startInChunk, int endInChunk) noexcept;
+
+    std::vector<std::unique_ptr<AcousticAnalysisEngine>> engines;
+
+    // One maxChunkSize lane per stream: input channels first, then the derived views
+    std::vector<float> scratch;
+    int midStream = -1, sideStream = -1, sumStream = -1;
+
+    std::vector<std::vector<AnalysisFrame>> pendingFrames;
+    std::vector<AnalysisFrame> hopFrames;
+    std::vector<float> pendingSpectra;     // one spectrum per pending frame of the spectrum stream
+    int spectrumStream = 0;
+
+    LoudnessMeter loudness;
+    std::vector<const float*> loudnessInputs;
+    juce::int64 chunkStartSample = 0;      // stream position of the chunk being processed
+
+    double currentSampleRate = 44100.0;
+    int numInputChannels = 0;
+    int hopSize = AcousticAnalysisEngine::fftSize / 2;
+    Options options;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MultichannelAnalysisEngine)
+};
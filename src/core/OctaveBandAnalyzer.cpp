@@ -0,0 +1,372 @@
+#include "OctaveBandAnalyzer.h"
+#include <complex>
+
+namespace
+{
+    // Third-octave n sits at 1000 * 2^((n - 17) / 3) Hz
+    constexpr int thousandHertzBand = 17;
+
+    const char* const thirdOctaveNames[OctaveBandAnalyzer::numThirdOctaveBands] = {
+        "20", "25", "31.5", "40", "50", "63", "80", "100", "125", "160", "200", "250", "315", "400", "500", "630",
+        "800", "1000", "1250", "1600", "2000", "2500", "3150", "4000", "5000", "6300", "8000", "10000", "12500",
+        "16000", "20000"
+    };
+
+    // Octave n is the sum of third-octaves 3n + 1 to 3n + 3
+    const char* const octaveNames[OctaveBandAnalyzer::numOctaveBands] = {
+        "31.5", "63", "125", "250", "500", "1000", "2000", "4000", "8000", "16000"
+    };
+
+    double powerToLevel(double meanSquare) noexcept
+    {
+        return meanSquare > 0.0 ? juce::jmax(static_cast<double>(OctaveBandAnalyzer::minimumLevel), 10.0 * std::log10(meanSquare))
+                                : static_cast<double>(OctaveBandAnalyzer::minimumLevel);
+    }
+}
+
+//==============================================================================
+void OctaveBandAnalyzer::Biquad::process(float* data, int numSamples) noexcept
+{
+    auto z1 = s1, z2 = s2;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto x = data[i];
+        const auto y = b0 * x + z1;
+        z1 = b1 * x - a1 * y + z2;
+        z2 = b2 * x - a2 * y;
+        data[i] = y;
+    }
+
+    s1 = z1;
+    s2 = z2;
+}
+
+double OctaveBandAnalyzer::getThirdOctaveFrequency(int band) noexcept
+{
+    return 1000.0 * std::pow(2.0, (band - thousandHertzBand) / 3.0);
+}
+
+const char* OctaveBandAnalyzer::getThirdOctaveName(int band) noexcept
+{
+    return juce::isPositiveAndBelow(band, numThirdOctaveBands) ? thirdOctaveNames[band] : "";
+}
+
+const char* OctaveBandAnalyzer::getOctaveName(int band) noexcept
+{
+    return juce::isPositiveAndBelow(band, numOctaveBands) ? octaveNames[band] : "";
+}
+
+//==============================================================================
+std::array<OctaveBandAnalyzer::Biquad, 3> OctaveBandAnalyzer::designBandPass(double lowerEdge, double upperEdge, double sampleRate)
+{
+    using Complex = std::complex<double>;
+
+    // Prewarped edges for the bilinear transform s = (z - 1) / (z + 1)
+    const auto w1 = std::tan(juce::MathConstants<double>::pi * lowerEdge / sampleRate);
+    const auto w2 = std::tan(juce::MathConstants<double>::pi * upperEdge / sampleRate);
+    const auto centre = std::sqrt(w1 * w2);
+    const auto bandwidth = w2 - w1;
+
+    // Third-order Butterworth low-pass prototype, moved to band-pass: each pole p becomes
+    // the two roots of s^2 - p B s + w0^2. Keep the upper-half-plane one of each conjugate pair.
+    std::vector<Complex> poles;
+
+    for (int k = 0; k < 3; ++k)
+    {
+        const auto prototype = std::polar(1.0, juce::MathConstants<double>::pi * (2 * k + 4) / 6.0);
+        const auto root = std::sqrt(prototype * prototype * bandwidth * bandwidth - 4.0 * centre * centre);
+
+        for (auto s : { (prototype * bandwidth + root) * 0.5, (prototype * bandwidth - root) * 0.5 })
+            if (s.imag() > 0.0)
+                poles.push_back(s);
+    }
+
+    jassert(poles.size() == 3);
+
+    // Each section has one zero at DC and one at Nyquist; normalise to unity gain at the centre
+    const auto centreZ = std::polar(1.0, 2.0 * std::atan(centre));
+    std::array<Biquad, 3> sections;
+    Complex response(1.0, 0.0);
+
+    for (size_t i = 0; i < sections.size(); ++i)
+    {
+        const auto z = (1.0 + poles[i]) / (1.0 - poles[i]);
+        const auto a1 = -2.0 * z.real();
+        const auto a2 = std::norm(z);
+
+        sections[i].b0 = 1.0f;
+        sections[i].b1 = 0.0f;
+        sections[i].b2 = -1.0f;
+        sections[i].a1 = static_cast<float>(a1);
+        sections[i].a2 = static_cast<float>(a2);
+
+        const auto zInverse = 1.0 / centreZ;
+        response *= (1.0 - zInverse * zInverse) / (1.0 + a1 * zInverse + a2 * zInverse * zInverse);
+    }
+
+    const auto gain = static_cast<float>(std::cbrt(1.0 / std::abs(response)));
+
+    for (auto& section : sections)
+    {
+        section.b0 *= gain;
+        section.b2 *= gain;
+    }
+
+    return sections;
+}
+
+OctaveBandAnalyzer::Biquad OctaveBandAnalyzer::designLowPass(double normalisedCutoff, double q)
+{
+    // RBJ low-pass
+    const auto w0 = juce::MathConstants<double>::twoPi * normalisedCutoff;
+    const auto alpha = std::sin(w0) / (2.0 * q);
+    const auto a0 = 1.0 + alpha;
+
+    Biquad section;
+    section.b0 = static_cast<float>((1.0 - std::cos(w0)) * 0.5 / a0);
+    section.b1 = static_cast<float>((1.0 - std::cos(w0)) / a0);
+    section.b2 = section.b0;
+    section.a1 = static_cast<float>(-2.0 * std::cos(w0) / a0);
+    section.a2 = static_cast<float>((1.0 - alpha) / a0);
+    return section;
+}
+
+std::array<OctaveBandAnalyzer::Biquad, 4> OctaveBandAnalyzer::designAntiAlias()
+{
+    // Eighth-order Butterworth as four sections with the Butterworth Qs
+    std::array<Biquad, 4> sections;
+
+    for (size_t k = 0; k < sections.size(); ++k)
+        sections[k] = designLowPass(antiAliasCutoff, 1.0 / (2.0 * std::sin(juce::MathConstants<double>::pi * (2.0 * static_cast<double>(k) + 1.0) / 16.0)));
+
+    return sections;
+}
+
+//==============================================================================
+void OctaveBandAnalyzer::prepare(double sampleRate)
+{
+    int numStages = 1;
+
+    for (int band = 0; band < numThirdOctaveBands; ++band)
+    {
+        const auto centre = getThirdOctaveFrequency(band);
+        const auto lowerEdge = centre * std::pow(2.0, -1.0 / 6.0);
+        const auto upperEdge = centre * std::pow(2.0, 1.0 / 6.0);
+        auto& b = bands[(size_t)band];
+
+        // Lowest stage whose rate still leaves the band well clear of Nyquist
+        b.stage = -1;
+
+        if (upperEdge < sampleRate * 0.49)
+        {
+            b.stage = 0;
+
+            while (b.stage + 1 < maxStages && upperEdge <= bandLimit * sampleRate / std::pow(2.0, b.stage + 1))
+                ++b.stage;
+
+            b.sections = designBandPass(lowerEdge, upperEdge, sampleRate / std::pow(2.0, b.stage));
+            numStages = juce::jmax(numStages, b.stage + 1);
+        }
+
+        // Envelopes come out at sampleRate / envelopeDecimation whatever the band's stage,
+        // smoothed to 0.4 of that rate so the rectified carrier doesn't alias into them
+        b.envelopeDecimation = b.stage >= 0 ? envelopeDecimation >> b.stage : 0;
+
+        if (b.envelopeDecimation > 0)
+            b.envelopeFilter = designLowPass(0.4 / b.envelopeDecimation, 0.7071);
+    }
+
+    envelopeRate = sampleRate / envelopeDecimation;
+    envelopes.assign((size_t)numThirdOctaveBands * envelopeRingSize, 0.0f);
+
+    powerStepLength = juce::jmax(1, static_cast<int>(std::lround(powerStepDuration * sampleRate)));
+    powerStepRate = sampleRate / powerStepLength;
+    powerSteps.assign((size_t)numThirdOctaveBands * powerRingSize, 0.0f);
+
+    stages.clear();
+    stages.resize((size_t)numStages);
+
+    for (int s = 0; s < numStages; ++s)
+    {
+        auto& stage = stages[(size_t)s];
+        stage.antiAlias = designAntiAlias();
+        stage.input.assign((size_t)(maxBlockSize >> s) + 1, 0.0f);
+    }
+
+    for (int band = 0; band < numThirdOctaveBands; ++band)
+        if (bands[(size_t)band].stage >= 0)
+            stages[(size_t)bands[(size_t)band].stage].bands.push_back(band);
+
+    scratch.assign((size_t)maxBlockSize, 0.0f);
+    reset();
+}
+
+void OctaveBandAnalyzer::reset()
+{
+    for (auto& band : bands)
+    {
+        for (auto& section : band.sections)
+            section.s1 = section.s2 = 0.0f;
+
+        band.energy = 0.0;
+        band.meanSquare = 0.0;
+        band.stepEnergy = 0.0;
+
+        band.envelopeFilter.s1 = band.envelopeFilter.s2 = 0.0f;
+        band.envelopePhase = 0;
+        band.numEnvelopeSamples = 0;
+    }
+
+    std::fill(envelopes.begin(), envelopes.end(), 0.0f);
+    std::fill(powerSteps.begin(), powerSteps.end(), 0.0f);
+    powerStepFill = 0;
+    numPowerSteps = 0;
+
+    for (auto& stage : stages)
+    {
+        for (auto& section : stage.antiAlias)
+            section.s1 = section.s2 = 0.0f;
+
+        stage.decimationPhase = 0;
+        stage.samplesSinceRead = 0;
+        stage.samplesSinceStep = 0;
+    }
+}
+
+void OctaveBandAnalyzer::process(const float* samples, int numSamples) noexcept
+{
+    for (int offset = 0; offset < numSamples;)
+    {
+        // Runs end on power step boundaries
+        const float* input = samples + offset;
+        auto count = juce::jmin(maxBlockSize, numSamples - offset, powerStepLength - powerStepFill);
+
+        offset += count;
+        powerStepFill += count;
+
+        for (size_t s = 0; s < stages.size() && count > 0; ++s)
+        {
+            auto& stage = stages[s];
+
+            for (auto index : stage.bands)
+            {
+                auto& band = bands[(size_t)index];
+                juce::FloatVectorOperations::copy(scratch.data(), input, count);
+
+                for (auto& section : band.sections)
+                    section.process(scratch.data(), count);
+
+                double sum = 0.0;
+                for (int i = 0; i < count; ++i)
+                    sum += scratch[(size_t)i] * scratch[(size_t)i];
+
+                band.energy += sum;
+                band.stepEnergy += sum;
+
+                if (band.envelopeDecimation > 0)
+                    trackEnvelope(band, index, count);
+            }
+
+            stage.samplesSinceRead += count;
+            stage.samplesSinceStep += count;
+
+            if (s + 1 == stages.size())
+                break;
+
+            // Low-pass and keep every other sample, carrying the phase across blocks
+            juce::FloatVectorOperations::copy(scratch.data(), input, count);
+
+            for (auto& section : stage.antiAlias)
+                section.process(scratch.data(), count);
+
+            auto& next = stages[s + 1];
+            int decimated = 0;
+
+            for (int i = stage.decimationPhase; i < count; i += 2)
+                next.input[(size_t)decimated++] = scratch[(size_t)i];
+
+            stage.decimationPhase = (stage.decimationPhase + count) & 1;
+            input = next.input.data();
+            count = decimated;
+        }
+
+        if (powerStepFill == powerStepLength)
+            completePowerStep();
+    }
+}
+
+void OctaveBandAnalyzer::completePowerStep() noexcept
+{
+    auto* step = powerSteps.data() + (size_t)(numPowerSteps & (powerRingSize - 1)) * numThirdOctaveBands;
+    const auto* previous = powerSteps.data() + (size_t)((numPowerSteps - 1) & (powerRingSize - 1)) * numThirdOctaveBands;
+
+    for (int index = 0; index < numThirdOctaveBands; ++index)
+    {
+        auto& band = bands[(size_t)index];
+
+        if (band.stage < 0)
+        {
+            step[index] = 0.0f;
+            continue;
+        }
+
+        // A low stage can go a whole step without an output sample; hold its previous power then
+        const auto numSamples = stages[(size_t)band.stage].samplesSinceStep;
+        step[index] = numSamples > 0 ? static_cast<float>(band.stepEnergy / numSamples) : previous[index];
+        band.stepEnergy = 0.0;
+    }
+
+    for (auto& stage : stages)
+        stage.samplesSinceStep = 0;
+
+    ++numPowerSteps;
+    powerStepFill = 0;
+}
+
+void OctaveBandAnalyzer::trackEnvelope(Band& band, int index, int count) noexcept
+{
+    // The band signal is still in the scratch buffer
+    juce::FloatVectorOperations::abs(scratch.data(), scratch.data(), count);
+    band.envelopeFilter.process(scratch.data(), count);
+
+    auto* ring = envelopes.data() + (size_t)index * envelopeRingSize;
+
+    for (int i = band.envelopeDecimation - 1 - band.envelopePhase; i < count; i += band.envelopeDecimation)
+        ring[(size_t)(band.numEnvelopeSamples++ & (envelopeRingSize - 1))] = scratch[(size_t)i];
+
+    band.envelopePhase = (band.envelopePhase + count) % band.envelopeDecimation;
+}
+
+void OctaveBandAnalyzer::readLevels(float* thirdOctaveLevels, float* octaveLevels) noexcept
+{
+    for (int index = 0; index < numThirdOctaveBands; ++index)
+    {
+        auto& band = bands[(size_t)index];
+
+        if (band.stage >= 0)
+        {
+            const auto numSamples = stages[(size_t)band.stage].samplesSinceRead;
+
+            if (numSamples > 0)
+                band.meanSquare = band.energy / static_cast<double>(numSamples);
+
+            band.energy = 0.0;
+        }
+
+        thirdOctaveLevels[index] = static_cast<float>(powerToLevel(band.meanSquare));
+    }
+
+    for (auto& stage : stages)
+        stage.samplesSinceRead = 0;
+
+    for (int octave = 0; octave < numOctaveBands; ++octave)
+    {
+        double sum = 0.0;
+
+        for (int third = 3 * octave + 1; third <= 3 * octave + 3; ++third)
+            sum += bands[(size_t)third].meanSquare;
+
+        octaveLevels[octave] = static_cast<float>(powerToLevel(sum));
+    }
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <vector>
+
+//==============================================================================
+/**
+    Third-octave and octave band levels from 20 Hz to 20 kHz, in the style of IEC 61260
+    (base-2 midband frequencies, sixth-order Butterworth band filters).
+
+    Low bands are narrow, so filtering them at the full sample rate would be both costly
+    and numerically poor. Instead the signal runs down a decimate-by-two tree: each stage
+    low-passes its input with an eighth-order Butterworth and keeps every other sample
+    for the next. Every band is filtered at the lowest rate where its upper edge is still
+    below a quarter of that rate, so all bands sit at similar normalised frequencies and
+    the whole tree costs about twice the top octave.
+
+    Octave levels are the energy sums of their three third-octave bands.
+
+    Bands filtered at a rate of at least sampleRate / envelopeDecimation also keep their
+    envelope: the rectified band signal is low-passed and decimated to that common rate
+    and kept in a short ring per band, for modulation analysis (roughness) without a
+    second filterbank.
+
+    Band powers are also summed over fixed steps of about 2 ms of input, whatever the
+    block size, and the mean squares of the latest steps kept in a ring: the time base
+    for time-varying loudness. Nothing allocates after prepare().
+*/
+class OctaveBandAnalyzer
+{
+public:
+    static constexpr int numThirdOctaveBands = 31;  // 20 Hz to 20 kHz
+    static constexpr int numOctaveBands = 10;       // 31.5 Hz to 16 kHz
+    static constexpr float minimumLevel = -100.0f;
+
+    static constexpr int envelopeDecimation = 32;   // envelope rate is sampleRate / 32
+    static constexpr int envelopeRingSize = 512;    // envelope samples kept per band
+
+    static constexpr double powerStepDuration = 0.002;  // seconds, rounded to whole samples
+    static constexpr int powerRingSize = 256;           // power steps kept
+
+    OctaveBandAnalyzer() = default;
+
+    /** Designs the filters and allocates the stage buffers. Not real-time safe. */
+    void prepare(double sampleRate);
+    void reset();
+
+    /** Real-time safe. */
+    void process(const float* samples, int numSamples) noexcept;
+
+    /**
+        Writes the level of every band over the samples processed since the previous call,
+        in dB relative to a full-scale RMS of 1, and starts a new integration period.
+        Bands whose stage produced no output since then keep their previous level; bands
+        above Nyquist read minimumLevel.
+    */
+    void readLevels(float* thirdOctaveLevels, float* octaveLevels) noexcept;
+
+    /** Exact base-2 midband frequency, 1000 * 2^(n / 3). */
+    static double getThirdOctaveFrequency(int band) noexcept;
+
+    /** Nominal labels as printed on reports: "20", "31.5", "1000", "12500"... */
+    static const char* getThirdOctaveName(int band) noexcept;
+    static const char* getOctaveName(int band) noexcept;
+
+    bool isBandAvailable(int band) const noexcept { return bands[(size_t)band].stage >= 0; }
+    int getNumStages() const noexcept { return static_cast<int>(stages.size()); }
+
+    //==============================================================================
+    double getEnvelopeRate() const noexcept { return envelopeRate; }
+
+    /** False for bands above Nyquist and for bands filtered below the envelope rate. */
+    bool hasEnvelope(int band) const noexcept { return bands[(size_t)band].envelopeDecimation > 0; }
+
+    /** Envelope samples written to a band since reset(). */
+    juce::int64 getNumEnvelopeSamples(int band) const noexcept { return bands[(size_t)band].numEnvelopeSamples; }
+
+    /** Envelope sample by absolute index; only the last envelopeRingSize are kept. */
+    float getEnvelopeSample(int band, juce::int64 index) const noexcept
+    {
+        return envelopes[(size_t)band * envelopeRingSize + (size_t)(index & (envelopeRingSize - 1))];
+    }
+
+    //==============================================================================
+    /** Input samples per power step. */
+    int getPowerStepLength() const noexcept { return powerStepLength; }
+    double getPowerStepRate() const noexcept { return powerStepRate; }
+
+    /** Power steps completed since reset(). */
+    juce::int64 getNumPowerSteps() const noexcept { return numPowerSteps; }
+
+    /**
+        Mean square of every third-octave band over one step, by absolute step index; only
+        the last powerRingSize are kept. Bands above Nyquist read 0.
+    */
+    const float* getPowerStep(juce::int64 index) const noexcept
+    {
+        return powerSteps.data() + (size_t)(index & (powerRingSize - 1)) * numThirdOctaveBands;
+    }
+
+private:
+    static constexpr int maxBlockSize = 1024;
+    static constexpr int maxStages = 16;
+    static constexpr double bandLimit = 0.25;       // highest upper band edge, as a fraction of the stage rate
+    static constexpr double antiAliasCutoff = 0.16; // fraction of the rate of the stage being decimated
+
+    struct Biquad
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+        float s1 = 0.0f, s2 = 0.0f;
+
+        void process(float* data, int numSamples) noexcept;
+    };
+
+    struct Band
+    {
+        std::array<Biquad, 3> sections;
+        int stage = -1;                 // -1 if the band doesn't fit below Nyquist
+        double energy = 0.0;            // sum of squares since the last read
+        double meanSquare = 0.0;
+        double stepEnergy = 0.0;        // sum of squares in the current power step
+
+        Biquad envelopeFilter;          // smooths the rectified band signal before decimation
+        int envelopeDecimation = 0;     // band samples per envelope sample; 0 if no envelope
+        int envelopePhase = 0;
+        juce::int64 numEnvelopeSamples = 0;
+    };
+
+    struct Stage
+    {
+        std::vector<int> bands;
+        std::array<Biquad, 4> antiAlias;
+        std::vector<float> input;       // decimated output of the stage above; unused by stage 0
+        int decimationPhase = 0;
+        juce::int64 samplesSinceRead = 0;
+        int samplesSinceStep = 0;
+    };
+
+    void trackEnvelope(Band& band, int index, int count) noexcept;
+    void completePowerStep() noexcept;
+
+    static std::array<Biquad, 3> designBandPass(double lowerEdge, double upperEdge, double sampleRate);
+    static Biquad designLowPass(double normalisedCutoff, double q);
+    static std::array<Biquad, 4> designAntiAlias();
+
+    std::array<Band, numThirdOctaveBands> bands;
+    std::vector<Stage> stages;
+    std::vector<float> scratch;
+    std::vector<float> envelopes;       // envelopeRingSize per band
+    double envelopeRate = 0.0;
+
+    std::vector<float> powerSteps;      // numThirdOctaveBands per step
+    int powerStepLength = 1;
+    int powerStepFill = 0;
+    double powerStepRate = 0.0;
+    juce::int64 numPowerSteps = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OctaveBandAnalyzer)
+};
@@ -0,0 +1,161 @@
+#include "PerceptualFilterbank.h"
+
+namespace
+{
+    constexpr int numLanes = 8;
+
+    // Lane-wise accumulators so the compiler can vectorise without reassociating the sum
+    inline float dotProduct(const float* a, const float* b, int count) noexcept
+    {
+        float lanes[numLanes] = {};
+        const auto numWhole = count / numLanes * numLanes;
+
+        for (int i = 0; i < numWhole; i += numLanes)
+            for (int lane = 0; lane < numLanes; ++lane)
+                lanes[lane] += a[i + lane] * b[i + lane];
+
+        for (int i = numWhole; i < count; ++i)
+            lanes[i - numWhole] += a[i] * b[i];
+
+        float sum = 0.0f;
+        for (int lane = 0; lane < numLanes; ++lane)
+            sum += lanes[lane];
+
+        return sum;
+    }
+}
+
+//==============================================================================
+float PerceptualFilterbank::frequencyToScale(Scale scale, float frequency) noexcept
+{
+    switch (scale)
+    {
+        case Scale::bark:   return 26.81f * frequency / (1960.0f + frequency) - 0.53f;
+        case Scale::erb:    return 21.4f * std::log10(1.0f + 0.00437f * frequency);
+        case Scale::mel:
+        default:            return 2595.0f * std::log10(1.0f + frequency / 700.0f);
+    }
+}
+
+float PerceptualFilterbank::scaleToFrequency(Scale scale, float value) noexcept
+{
+    switch (scale)
+    {
+        case Scale::bark:   return 1960.0f * (value + 0.53f) / (26.28f - value);
+        case Scale::erb:    return (std::pow(10.0f, value / 21.4f) - 1.0f) / 0.00437f;
+        case Scale::mel:
+        default:            return 700.0f * (std::pow(10.0f, value / 2595.0f) - 1.0f);
+    }
+}
+
+//==============================================================================
+void PerceptualFilterbank::prepare(double sampleRate, int fftSize, const Options& optionsToUse)
+{
+    options = optionsToUse;
+    numBins = fftSize / 2;
+
+    const auto nyquist = static_cast<float>(sampleRate * 0.5);
+    const auto numBands = juce::jlimit(minBands, maxBands, options.numBands);
+    const auto maxFrequency = options.maxFrequency > 0.0f ? juce::jmin(options.maxFrequency, nyquist) : nyquist;
+    const auto minFrequency = juce::jlimit(0.0f, maxFrequency * 0.5f, options.minFrequency);
+
+    options.numBands = numBands;
+    options.maxFrequency = maxFrequency;
+    options.minFrequency = minFrequency;
+    options.numCoefficients = juce::jlimit(0, numBands, options.numCoefficients);
+
+    // numBands + 2 edges evenly spaced on the scale; band b rises from edge b to b + 1 and falls to b + 2
+    const auto scaleMin = frequencyToScale(options.scale, minFrequency);
+    const auto scaleMax = frequencyToScale(options.scale, maxFrequency);
+
+    std::vector<float> edges((size_t)numBands + 2);
+
+    for (size_t i = 0; i < edges.size(); ++i)
+        edges[i] = scaleToFrequency(options.scale, scaleMin + (scaleMax - scaleMin) * static_cast<float>(i) / static_cast<float>(numBands + 1));
+
+    const auto binWidth = static_cast<float>(sampleRate / fftSize);
+
+    // Unit power for a full-scale sine in its peak bin (Hann window, coherent gain 0.5)
+    const auto powerScale = 4.0f / (static_cast<float>(numBins) * static_cast<float>(numBins));
+
+    bands.assign((size_t)numBands, {});
+    weights.clear();
+
+    for (int b = 0; b < numBands; ++b)
+    {
+        const auto lower = edges[(size_t)b];
+        const auto centre = edges[(size_t)b + 1];
+        const auto upper = edges[(size_t)b + 2];
+
+        auto& band = bands[(size_t)b];
+        band.centreFrequency = centre;
+        band.weightOffset = weights.size();
+        band.firstBin = juce::jlimit(0, numBins - 1, static_cast<int>(std::floor(lower / binWidth)) + 1);
+
+        const auto lastBin = juce::jlimit(0, numBins - 1, static_cast<int>(std::ceil(upper / binWidth)) - 1);
+
+        for (int bin = band.firstBin; bin <= lastBin; ++bin)
+        {
+            const auto frequency = static_cast<float>(bin) * binWidth;
+            const auto weight = frequency <= centre ? (frequency - lower) / (centre - lower)
+                                                    : (upper - frequency) / (upper - centre);
+            weights.push_back(juce::jmax(0.0f, weight) * powerScale);
+        }
+
+        band.numWeights = static_cast<int>(weights.size() - band.weightOffset);
+
+        // Low bands can be narrower than a bin; they take the bin nearest their centre
+        if (band.numWeights == 0)
+        {
+            band.firstBin = juce::jlimit(0, numBins - 1, juce::roundToInt(centre / binWidth));
+            band.numWeights = 1;
+            weights.push_back(powerScale);
+        }
+    }
+
+    // Orthonormal DCT-II
+    const auto numCoefficients = options.numCoefficients;
+    dctMatrix.assign((size_t)(numCoefficients * numBands), 0.0f);
+
+    for (int k = 0; k < numCoefficients; ++k)
+    {
+        const auto norm = std::sqrt((k == 0 ? 1.0f : 2.0f) / static_cast<float>(numBands));
+
+        for (int n = 0; n < numBands; ++n)
+            dctMatrix[(size_t)(k * numBands + n)] = norm * std::cos(juce::MathConstants<float>::pi * static_cast<float>(k)
+                                                                    * (static_cast<float>(n) + 0.5f) / static_cast<float>(numBands));
+    }
+
+    power.assign((size_t)numBins, 0.0f);
+    bandEnergies.assign((size_t)numBands, 0.0f);
+    logEnergies.assign((size_t)numBands, 0.0f);
+    coefficients.assign((size_t)juce::jmax(1, numCoefficients), 0.0f);
+}
+
+void PerceptualFilterbank::process(const float* magnitudes) noexcept
+{
+    const auto numBands = getNumBands();
+
+    juce::FloatVectorOperations::multiply(power.data(), magnitudes, magnitudes, numBins);
+
+    for (int b = 0; b < numBands; ++b)
+    {
+        const auto& band = bands[(size_t)b];
+        bandEnergies[(size_t)b] = dotProduct(weights.data() + band.weightOffset, power.data() + band.firstBin, band.numWeights);
+    }
+
+    if (!options.logCompression && options.numCoefficients == 0)
+        return;
+
+    for (int b = 0; b < numBands; ++b)
+        logEnergies[(size_t)b] = std::log(juce::jmax(powerFloor, bandEnergies[(size_t)b]));
+
+    for (int k = 0; k < options.numCoefficients; ++k)
+        coefficients[(size_t)k] = dotProduct(dctMatrix.data() + k * numBands, logEnergies.data(), numBands);
+
+    if (options.logCompression)
+    {
+        // ln to dB
+        juce::FloatVectorOperations::multiply(bandEnergies.data(), logEnergies.data(), 10.0f / std::log(10.0f), numBands);
+    }
+}
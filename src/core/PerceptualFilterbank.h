@@ -0,0 +1,90 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <vector>
+
+//==============================================================================
+/**
+    Projects a magnitude spectrum onto perceptually spaced bands (Mel, Bark or ERB) and
+    optionally turns the log band energies into cepstral coefficients (MFCCs when the
+    scale is Mel).
+
+    Bands are triangles spaced evenly on the chosen scale. Each one only covers a short
+    run of bins, so prepare() stores just the non-zero weights of every band in one flat
+    table; process() squares the spectrum once and then does one short dot product per
+    band. The DCT is a precomputed matrix. Nothing allocates after prepare().
+*/
+class PerceptualFilterbank
+{
+public:
+    enum class Scale
+    {
+        mel,    // HTK: 2595 log10(1 + f / 700)
+        bark,   // Traunmueller (1990)
+        erb     // Glasberg & Moore (1990) ERB-rate
+    };
+
+    struct Options
+    {
+        Scale scale = Scale::mel;
+        int numBands = 40;              // clamped to [minBands, maxBands]
+        float minFrequency = 20.0f;
+        float maxFrequency = 0.0f;      // 0 or above Nyquist means Nyquist
+        bool logCompression = true;     // band energies in dB rather than linear power
+        int numCoefficients = 13;       // DCT outputs; 0 skips the DCT
+    };
+
+    static constexpr int minBands = 8;
+    static constexpr int maxBands = 64;
+
+    PerceptualFilterbank() = default;
+
+    /** Builds the weight and DCT tables. Allocates, so call from prepareToPlay. */
+    void prepare(double sampleRate, int fftSize, const Options& optionsToUse);
+
+    /**
+        Analyses fftSize / 2 magnitudes straight from the STFT. Power is scaled so a
+        full-scale sine has unit power (0 dB) in its peak bin. Real-time safe.
+    */
+    void process(const float* magnitudes) noexcept;
+
+    const Options& getOptions() const noexcept { return options; }
+    int getNumBands() const noexcept { return static_cast<int>(bands.size()); }
+    int getNumCoefficients() const noexcept { return options.numCoefficients; }
+
+    /** Band energies of the latest frame, linear power or dB depending on the options. */
+    const float* getBandEnergies() const noexcept { return bandEnergies.data(); }
+
+    /** Cepstral coefficients of the latest frame (orthonormal DCT-II of the natural-log band energies). */
+    const float* getCoefficients() const noexcept { return coefficients.data(); }
+
+    /** Centre frequency of a band in Hz. */
+    float getBandCentreFrequency(int band) const noexcept { return bands[(size_t)band].centreFrequency; }
+
+    static float frequencyToScale(Scale scale, float frequency) noexcept;
+    static float scaleToFrequency(Scale scale, float value) noexcept;
+
+private:
+    static constexpr float powerFloor = 1.0e-10f; // -100 dB
+
+    struct Band
+    {
+        int firstBin = 0;
+        int numWeights = 0;
+        size_t weightOffset = 0;
+        float centreFrequency = 0.0f;
+    };
+
+    Options options;
+    int numBins = 0;
+
+    std::vector<Band> bands;
+    std::vector<float> weights;         // every band's non-zero weights, back to back
+    std::vector<float> power;           // squared magnitudes of the current frame
+    std::vector<float> bandEnergies;
+    std::vector<float> logEnergies;
+    std::vector<float> dctMatrix;       // numCoefficients rows of numBands
+    std::vector<float> coefficients;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PerceptualFilterbank)
+};
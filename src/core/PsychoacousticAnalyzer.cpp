@@ -0,0 +1,207 @@
+#include "PsychoacousticAnalyzer.h"
+#include "PerceptualFilterbank.h"
+#include <iterator>
+
+namespace
+{
+    // The band filters attenuate the sidebands of faster modulations, so the envelope
+    // band-pass sits a little above 70 Hz to put the peak of the overall response there
+    constexpr double modulationCentre = 90.0;      // Hz
+    constexpr double modulationQ = 0.6;
+    constexpr float roughnessCalibration = 0.72f;  // 1 kHz at 60 dB, 100 % modulated at 70 Hz -> 1 asper
+
+    float getBark(double frequency)
+    {
+        return PerceptualFilterbank::frequencyToScale(PerceptualFilterbank::Scale::bark, static_cast<float>(frequency));
+    }
+
+    /** Terhardt's approximation of the threshold in quiet, dB SPL. */
+    float getThresholdInQuiet(double frequency)
+    {
+        const auto kHz = frequency / 1000.0;
+        return static_cast<float>(3.64 * std::pow(kHz, -0.8) - 6.5 * std::exp(-0.6 * (kHz - 3.3) * (kHz - 3.3)) + 1.0e-3 * std::pow(kHz, 4.0));
+    }
+
+    /** DIN 45692 weighting: flat up to 15.8 Bark, rising steeply above. */
+    float getSharpnessWeighting(float bark)
+    {
+        return bark <= 15.8f ? 1.0f : 0.15f * std::exp(0.42f * (bark - 15.8f)) + 0.85f;
+    }
+
+    /** Carrier weighting of roughness, after the curve of Daniel & Weber (1997). */
+    float getRoughnessWeighting(float bark)
+    {
+        constexpr float points[][2] = { { 0.0f, 0.5f }, { 3.0f, 0.8f }, { 6.0f, 1.0f }, { 11.0f, 1.0f }, { 16.0f, 0.8f }, { 24.0f, 0.5f } };
+
+        for (size_t i = 1; i < std::size(points); ++i)
+            if (bark <= points[i][0])
+                return juce::jmap(bark, points[i - 1][0], points[i][0], points[i - 1][1], points[i][1]);
+
+        return points[std::size(points) - 1][1];
+    }
+}
+
+//==============================================================================
+void PsychoacousticAnalyzer::prepare(const OctaveBandAnalyzer& bandsToUse, const Options& optionsToUse)
+{
+    options = optionsToUse;
+
+    for (int i = 0; i < numBands; ++i)
+    {
+        auto& band = bands[(size_t)i];
+        const auto centre = OctaveBandAnalyzer::getThirdOctaveFrequency(i);
+
+        band.criticalBandRate = getBark(centre);
+        band.threshold = getThresholdInQuiet(centre);
+        band.roughnessWeight = bandsToUse.hasEnvelope(i) ? getRoughnessWeighting(band.criticalBandRate) : 0.0f;
+    }
+
+    for (size_t i = 0; i < sharpnessWeights.size(); ++i)
+    {
+        const auto z = static_cast<float>(i + 1) * ZwickerLoudness::barkStep;
+        sharpnessWeights[i] = getSharpnessWeighting(z) * z;
+    }
+
+    const auto w0 = juce::MathConstants<double>::twoPi * modulationCentre / bandsToUse.getEnvelopeRate();
+    const auto alpha = std::sin(w0) / (2.0 * modulationQ);
+    const auto a0 = 1.0 + alpha;
+
+    b0 = alpha / a0;
+    b2 = -alpha / a0;
+    a1 = -2.0 * std::cos(w0) / a0;
+    a2 = (1.0 - alpha) / a0;
+
+    envelopes.assign((size_t)numBands * windowSize, 0.0f);
+    filtered.assign((size_t)numBands * windowSize, 0.0f);
+
+    reset();
+}
+
+void PsychoacousticAnalyzer::reset() noexcept
+{
+    for (auto& band : bands)
+    {
+        band.s1 = band.s2 = 0.0;
+        band.numEnvelopeSamplesRead = 0;
+        band.numFiltered = 0;
+    }
+}
+
+void PsychoacousticAnalyzer::processEnvelopes(const OctaveBandAnalyzer& bandsToUse) noexcept
+{
+    for (int i = 0; i < numBands; ++i)
+    {
+        auto& band = bands[(size_t)i];
+
+        if (band.roughnessWeight <= 0.0f)
+            continue;
+
+        const auto available = bandsToUse.getNumEnvelopeSamples(i);
+        auto* envelope = envelopes.data() + (size_t)i * windowSize;
+        auto* output = filtered.data() + (size_t)i * windowSize;
+        auto s1 = band.s1, s2 = band.s2;
+
+        for (auto index = juce::jmax(band.numEnvelopeSamplesRead, available - OctaveBandAnalyzer::envelopeRingSize); index < available; ++index)
+        {
+            const auto x = static_cast<double>(bandsToUse.getEnvelopeSample(i, index));
+            const auto y = b0 * x + s1;
+            s1 = -a1 * y + s2;
+            s2 = b2 * x - a2 * y;
+
+            const auto pos = (size_t)(band.numFiltered++ & (windowSize - 1));
+            envelope[pos] = static_cast<float>(x);
+            output[pos] = static_cast<float>(y);
+        }
+
+        band.s1 = s1;
+        band.s2 = s2;
+        band.numEnvelopeSamplesRead = available;
+    }
+}
+
+//==============================================================================
+float PsychoacousticAnalyzer::calculateSharpness(const ZwickerLoudness& loudness) const noexcept
+{
+    const auto* specific = loudness.getSpecificLoudness();
+    float total = 0.0f, weighted = 0.0f;
+
+    for (size_t i = 0; i < sharpnessWeights.size(); ++i)
+    {
+        total += specific[i];
+        weighted += specific[i] * sharpnessWeights[i];
+    }
+
+    return total > 0.0f ? 0.11f * weighted / total : 0.0f;
+}
+
+float PsychoacousticAnalyzer::calculateRoughness(const float* thirdOctaveLevels) const noexcept
+{
+    // Bands that take part: an envelope, enough of it, and a carrier above the threshold in quiet
+    std::array<bool, numBands> active{};
+    juce::int64 length = windowSize;
+
+    for (int i = 0; i < numBands; ++i)
+    {
+        const auto& band = bands[(size_t)i];
+        active[(size_t)i] = band.roughnessWeight > 0.0f && band.numFiltered > 0
+                            && thirdOctaveLevels[i] + options.fullScaleLevel > band.threshold;
+
+        if (active[(size_t)i])
+            length = juce::jmin(length, band.numFiltered);
+    }
+
+    const auto n = static_cast<int>(length);
+
+    // Index of the j-th of the last n samples of a band
+    auto at = [this, n](int band, int j)
+        {
+            return (size_t)band * windowSize + (size_t)((bands[(size_t)band].numFiltered - n + j) & (windowSize - 1));
+        };
+
+    std::array<float, numBands> depth{}, energy{}, correlation{};   // correlation[i] is between bands i and i + 1
+
+    for (int i = 0; i < numBands; ++i)
+    {
+        if (!active[(size_t)i])
+            continue;
+
+        float sum = 0.0f, sumOfSquares = 0.0f;
+
+        for (int j = 0; j < n; ++j)
+        {
+            const auto index = at(i, j);
+            sum += envelopes[index];
+            sumOfSquares += filtered[index] * filtered[index];
+        }
+
+        const auto mean = sum / static_cast<float>(n);
+        depth[(size_t)i] = mean > 0.0f ? juce::jmin(1.0f, std::sqrt(sumOfSquares / static_cast<float>(n)) / mean) : 0.0f;
+        energy[(size_t)i] = sumOfSquares;
+    }
+
+    for (int i = 0; i + 1 < numBands; ++i)
+    {
+        if (!active[(size_t)i] || !active[(size_t)i + 1] || energy[(size_t)i] <= 0.0f || energy[(size_t)i + 1] <= 0.0f)
+            continue;
+
+        float cross = 0.0f;
+
+        for (int j = 0; j < n; ++j)
+            cross += filtered[at(i, j)] * filtered[at(i + 1, j)];
+
+        correlation[(size_t)i] = juce::jmax(0.0f, cross / std::sqrt(energy[(size_t)i] * energy[(size_t)i + 1]));
+    }
+
+    float roughness = 0.0f;
+
+    for (int i = 0; i < numBands; ++i)
+    {
+        const auto left = i > 0 ? correlation[(size_t)i - 1] : 0.0f;
+        const auto right = correlation[(size_t)i];
+        const auto specific = bands[(size_t)i].roughnessWeight * depth[(size_t)i] * left * right;
+
+        roughness += specific * specific;
+    }
+
+    return roughnessCalibration * roughness;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "OctaveBandAnalyzer.h"
+#include "ZwickerLoudness.h"
+#include <array>
+#include <vector>
+
+//==============================================================================
+/**
+    Sharpness (DIN 45692, acum) and a Daniel & Weber style roughness estimate (asper),
+    both built on the third-octave bands of an OctaveBandAnalyzer rather than a filterbank
+    of their own.
+
+    Sharpness weights the specific loudness pattern of a ZwickerLoudness by critical-band
+    rate and the DIN g(z), so it shares the loudness model instead of running another.
+
+    Roughness uses the decimated band envelopes: each new envelope sample goes through a
+    band-pass that makes the response peak at 70 Hz, the modulation rate the ear hears as
+    roughest, and the last windowSize samples of each band are kept. Per frame, every
+    band's modulation depth is the RMS of its filtered envelope over its mean, weighted by
+    the carrier band and by how well its filtered envelope correlates with both
+    neighbours: R = c * sum((g(z) m k_left k_right)^2). The window is fixed, so the
+    per-frame cost is too, whatever the hop. Nothing allocates after prepare().
+*/
+class PsychoacousticAnalyzer
+{
+public:
+    struct Options
+    {
+        float fullScaleLevel = 100.0f;  // dB SPL of a full-scale RMS of 1
+    };
+
+    static constexpr int windowSize = 256;  // envelope samples, ~170 ms at 48 kHz
+
+    PsychoacousticAnalyzer() = default;
+
+    /** Builds the band tables for a prepared OctaveBandAnalyzer. Not real-time safe. */
+    void prepare(const OctaveBandAnalyzer& bandsToUse, const Options& optionsToUse);
+    void prepare(const OctaveBandAnalyzer& bandsToUse) { prepare(bandsToUse, Options()); }
+    void reset() noexcept;
+
+    /** Pulls the envelope samples written since the previous call through the modulation filters. */
+    void processEnvelopes(const OctaveBandAnalyzer& bandsToUse) noexcept;
+
+    /** DIN 45692 sharpness in acum, from the specific loudness of the latest loudness step. */
+    float calculateSharpness(const ZwickerLoudness& loudness) const noexcept;
+
+    /** Roughness in asper over the last windowSize envelope samples. */
+    float calculateRoughness(const float* thirdOctaveLevels) const noexcept;
+
+    /** dB SPL of a full-scale RMS of 1. Takes effect from the next frame. */
+    void setFullScaleLevel(float newLevel) noexcept { options.fullScaleLevel = newLevel; }
+
+    const Options& getOptions() const noexcept { return options; }
+
+private:
+    static constexpr int numBands = OctaveBandAnalyzer::numThirdOctaveBands;
+
+    struct Band
+    {
+        float criticalBandRate = 0.0f;  // Bark at the centre
+        float threshold = 0.0f;         // threshold in quiet, dB SPL
+        float roughnessWeight = 0.0f;   // carrier weighting, 0 without an envelope
+
+        // Modulation filter state and how far the envelope has been read
+        double s1 = 0.0, s2 = 0.0;
+        juce::int64 numEnvelopeSamplesRead = 0;
+        juce::int64 numFiltered = 0;
+    };
+
+    Options options;
+    std::array<Band, numBands> bands;
+    std::array<float, ZwickerLoudness::numSpecificLoudnessValues> sharpnessWeights{};   // DIN 45692 g(z) * z
+
+    // RBJ band-pass at 70 Hz on the envelope rate
+    double b0 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+
+    std::vector<float> envelopes;       // windowSize per band
+    std::vector<float> filtered;        // windowSize per band
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PsychoacousticAnalyzer)
+};
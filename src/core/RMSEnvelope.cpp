@@ -0,0 +1,46 @@
+#include "RMSEnvelope.h"
+
+//==============================================================================
+void RMSEnvelope::prepare(double sampleRate, double frameDuration, double historyDuration)
+{
+    currentSampleRate = sampleRate;
+    frameLength = juce::jmax(1, juce::roundToInt(frameDuration * sampleRate));
+    history.assign((size_t)juce::jmax(2, juce::roundToInt(historyDuration / frameDuration)), 0.0f);
+
+    reset();
+}
+
+void RMSEnvelope::reset() noexcept
+{
+    std::fill(history.begin(), history.end(), 0.0f);
+    sumOfSquares = 0.0;
+    fill = 0;
+    numFramesCompleted = 0;
+}
+
+void RMSEnvelope::process(const float* samples, int numSamples) noexcept
+{
+    int offset = 0;
+
+    while (offset < numSamples)
+    {
+        // Runs end at frame boundaries, so a frame never depends on where the blocks were cut
+        const auto count = juce::jmin(numSamples - offset, frameLength - fill);
+        auto sum = sumOfSquares;
+
+        for (int i = 0; i < count; ++i)
+            sum += static_cast<double>(samples[offset + i]) * samples[offset + i];
+
+        sumOfSquares = sum;
+        fill += count;
+        offset += count;
+
+        if (fill == frameLength)
+        {
+            history[(size_t)(numFramesCompleted % static_cast<juce::int64>(history.size()))] = static_cast<float>(std::sqrt(sumOfSquares / frameLength));
+            ++numFramesCompleted;
+            sumOfSquares = 0.0;
+            fill = 0;
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <vector>
+
+//==============================================================================
+/**
+    Fixed-rate RMS envelope: the RMS of every frameDuration of signal (10 ms by default),
+    with the latest historyDuration of frames kept in a ring.
+
+    Frames are counted in samples, so blocks of any size are split or joined internally
+    and the envelope is the same whatever the host buffer size or the STFT hop. A sample
+    costs one multiply-add into a running sum; a completed frame costs a square root and
+    a ring write. Nothing allocates after prepare().
+*/
+class RMSEnvelope
+{
+public:
+    static constexpr double defaultFrameDuration = 0.01;
+    static constexpr double defaultHistoryDuration = 2.5;
+
+    RMSEnvelope() = default;
+
+    /** Allocates the history and resets. Not real-time safe. */
+    void prepare(double sampleRate, double frameDuration = defaultFrameDuration, double historyDuration = defaultHistoryDuration);
+
+    /** Clears the history and the partial frame. */
+    void reset() noexcept;
+
+    /** Feeds a block of any size. Real-time safe. */
+    void process(const float* samples, int numSamples) noexcept;
+
+    /** Completed frames in the history, up to getHistorySize(). */
+    int getNumFrames() const noexcept { return static_cast<int>(juce::jmin(numFramesCompleted, static_cast<juce::int64>(history.size()))); }
+
+    /** RMS of a frame in the history, index 0 being the oldest. */
+    float getFrame(int index) const noexcept
+    {
+        return history[(size_t)((numFramesCompleted - getNumFrames() + index) % static_cast<juce::int64>(history.size()))];
+    }
+
+    /** RMS of the frame with the given number, counted from the last reset, while it is still in the history. */
+    float getCompletedFrame(juce::int64 frameNumber) const noexcept
+    {
+        return history[(size_t)(frameNumber % static_cast<juce::int64>(history.size()))];
+    }
+
+    int getHistorySize() const noexcept { return static_cast<int>(history.size()); }
+    int getFrameLength() const noexcept { return frameLength; }
+    double getFrameRate() const noexcept { return currentSampleRate / frameLength; }
+    juce::int64 getNumFramesCompleted() const noexcept { return numFramesCompleted; }
+
+private:
+    double currentSampleRate = 44100.0;
+    int frameLength = 441;
+
+    double sumOfSquares = 0.0;  // of the partial frame
+    int fill = 0;               // samples in the partial frame
+
+    std::vector<float> history;
+    juce::int64 numFramesCompleted = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RMSEnvelope)
+};
@@ -0,0 +1,87 @@
+#include "STFTProcessor.h"
+
+//==============================================================================
+STFTProcessor::STFTProcessor(int fftOrder)
+    : fftSize(1 << fftOrder),
+    fft(fftOrder),
+    windowTable((size_t)fftSize),
+    inputBuffer((size_t)fftSize, 0.0f),
+    scratch((size_t)fftSize * 2, 0.0f),
+    hopSize(fftSize),
+    samplesUntilNextHop(fftSize)
+{
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(windowTable.data(), (size_t)fftSize,
+        juce::dsp::WindowingFunction<float>::hann);
+}
+
+void STFTProcessor::reset()
+{
+    std::fill(inputBuffer.begin(), inputBuffer.end(), 0.0f);
+    std::fill(scratch.begin(), scratch.end(), 0.0f);
+
+    writePos = 0;
+    samplesBuffered = 0;
+    samplesUntilNextHop = hopSize;
+    samplesProcessed = 0;
+}
+
+void STFTProcessor::setHopSize(int newHopSize)
+{
+    hopSize = juce::jlimit(1, fftSize, newHopSize);
+    samplesUntilNextHop = juce::jmin(samplesUntilNextHop, hopSize);
+}
+
+int STFTProcessor::getHopSizeForOverlap(int fftSize, Overlap overlap)
+{
+    switch (overlap)
+    {
+        case Overlap::half:          return fftSize / 2;
+        case Overlap::threeQuarters: return fftSize / 4;
+        case Overlap::sevenEighths:  return fftSize / 8;
+        case Overlap::none:
+        default:                     return fftSize;
+    }
+}
+
+int STFTProcessor::getHopSizeForFrameRate(int fftSize, double sampleRate, double framesPerSecond)
+{
+    if (framesPerSecond <= 0.0)
+        return fftSize;
+
+    return juce::jlimit(1, fftSize, juce::roundToInt(sampleRate / framesPerSecond));
+}
+
+float STFTProcessor::getLatestHopRMS() const noexcept
+{
+    const auto numSamples = juce::jmin(hopSize, samplesBuffered);
+
+    if (numSamples == 0)
+        return 0.0f;
+
+    auto sumOfSquares = [this](int start, int count)
+        {
+            float sum = 0.0f;
+
+            for (int i = start; i < start + count; ++i)
+                sum += inputBuffer[(size_t)i] * inputBuffer[(size_t)i];
+
+            return sum;
+        };
+
+    const auto start = (writePos - numSamples) & (fftSize - 1);
+    const auto firstPart = juce::jmin(numSamples, fftSize - start);
+    const auto sum = sumOfSquares(start, firstPart) + sumOfSquares(0, numSamples - firstPart);
+
+    return std::sqrt(sum / (float)numSamples);
+}
+
+void STFTProcessor::performTransform()
+{
+    // writePos points at the oldest sample, so the frame is [writePos, end) followed by [0, writePos)
+    const auto firstPart = fftSize - writePos;
+
+    juce::FloatVectorOperations::multiply(scratch.data(), inputBuffer.data() + writePos, windowTable.data(), firstPart);
+    juce::FloatVectorOperations::multiply(scratch.data() + firstPart, inputBuffer.data(), windowTable.data() + firstPart, writePos);
+
+    fft.performFrequencyOnlyForwardTransform(scratch.data());
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <vector>
+
+//==============================================================================
+/**
+    Short-time Fourier transform front end for the analyzer.
+
+    Incoming blocks are copied into a circular input buffer in as few vectorised
+    copies as possible. Every hopSize samples the most recent fftSize samples are
+    windowed into a separate scratch buffer and transformed, so the input history is
+    left intact and consecutive frames can overlap.
+*/
+class STFTProcessor
+{
+public:
+    enum class Overlap
+    {
+        none,           // hop = fftSize
+        half,           // hop = fftSize / 2
+        threeQuarters,  // hop = fftSize / 4
+        sevenEighths    // hop = fftSize / 8
+    };
+
+    explicit STFTProcessor(int fftOrder);
+
+    /** Forgets all buffered input. The next frame is produced once a full window has arrived. */
+    void reset();
+
+    /** Changes the hop, clamped to [1, fftSize] so frames never leave gaps. */
+    void setHopSize(int newHopSize);
+
+    int getHopSize() const noexcept { return hopSize; }
+    int getFFTSize() const noexcept { return fftSize; }
+    int getNumBins() const noexcept { return fftSize / 2; }
+
+    static int getHopSizeForOverlap(int fftSize, Overlap overlap);
+    static int getHopSizeForFrameRate(int fftSize, double sampleRate, double framesPerSecond);
+
+    /** Samples ingested since reset(). Inside a frame callback this is the frame's end position. */
+    juce::int64 getNumSamplesProcessed() const noexcept { return samplesProcessed; }
+
+    /** Magnitude spectrum of the most recent frame, getNumBins() values long. */
+    const float* getMagnitudes() const noexcept { return scratch.data(); }
+
+    /** RMS level of the samples that arrived during the most recent hop. */
+    float getLatestHopRMS() const noexcept;
+
+    /**
+        Feeds a block of samples and calls onFrame(magnitudes) for every frame that
+        completes inside it.
+    */
+    template <typename FrameCallback>
+    void process(const float* samples, int numSamples, FrameCallback&& onFrame)
+    {
+        while (numSamples > 0)
+        {
+            const auto chunk = juce::jmin(numSamples, samplesUntilNextHop, fftSize - writePos);
+
+            juce::FloatVectorOperations::copy(inputBuffer.data() + writePos, samples, chunk);
+
+            samples += chunk;
+            numSamples -= chunk;
+            writePos = (writePos + chunk) & (fftSize - 1);
+            samplesBuffered = juce::jmin(fftSize, samplesBuffered + chunk);
+            samplesProcessed += chunk;
+            samplesUntilNextHop -= chunk;
+
+            if (samplesUntilNextHop == 0)
+            {
+                samplesUntilNextHop = hopSize;
+
+                if (samplesBuffered == fftSize)
+                {
+                    performTransform();
+                    onFrame(getMagnitudes());
+                }
+            }
+        }
+    }
+
+private:
+    void performTransform();
+
+    const int fftSize;
+    juce::dsp::FFT fft;
+
+    std::vector<float> windowTable;
+    std::vector<float> inputBuffer;   // circular, fftSize samples
+    std::vector<float> scratch;       // windowed frame / FFT workspace, 2 * fftSize
+
+    int hopSize;
+    int writePos = 0;
+    int samplesBuffered = 0;
+    int samplesUntilNextHop;
+    juce::int64 samplesProcessed = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(STFTProcessor)
+};
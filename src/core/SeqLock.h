@@ -0,0 +1,81 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+//==============================================================================
+/**
+    Single-writer, multi-reader publication of a trivially copyable value.
+
+    The writer never waits: it bumps a sequence counter to odd, copies the value and
+    bumps it back to even. Readers copy the value and retry if the counter changed or
+    was odd while they were copying, so every read returns one complete value from a
+    single store() regardless of how large the struct grows.
+
+    The value is stored as relaxed atomic words, which keeps concurrent reads and writes
+    free of data races without any per-field atomics.
+*/
+template <typename ValueType>
+class SeqLock
+{
+public:
+    static_assert(std::is_trivially_copyable_v<ValueType>, "SeqLock values are copied as raw words");
+
+    SeqLock() { store(ValueType{}); }
+
+    /** Writer thread only. Never blocks. */
+    void store(const ValueType& value) noexcept
+    {
+        std::array<juce::uint64, numWords> source{};
+        std::memcpy(source.data(), &value, sizeof(ValueType));
+
+        const auto seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < numWords; ++i)
+            words[i].store(source[i], std::memory_order_relaxed);
+
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    /** Any thread. Retries only while a store() overlaps the read, which takes nanoseconds. */
+    ValueType load() const noexcept
+    {
+        std::array<juce::uint64, numWords> copy;
+
+        for (;;)
+        {
+            const auto before = sequence.load(std::memory_order_acquire);
+
+            if ((before & 1) == 0)
+            {
+                for (size_t i = 0; i < numWords; ++i)
+                    copy[i] = words[i].load(std::memory_order_relaxed);
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (sequence.load(std::memory_order_relaxed) == before)
+                    break;
+            }
+        }
+
+        ValueType value;
+        std::memcpy(static_cast<void*>(&value), copy.data(), sizeof(ValueType));
+        return value;
+    }
+
+    /** Number of completed stores; cheap way for a reader to tell whether anything changed. */
+    juce::uint64 getVersion() const noexcept { return sequence.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t numWords = (sizeof(ValueType) + sizeof(juce::uint64) - 1) / sizeof(juce::uint64);
+
+    std::atomic<juce::uint64> sequence{ 0 };
+    std::array<std::atomic<juce::uint64>, numWords> words{};
+
+    JUCE_DECLARE_NON_COPYABLE(SeqLock)
+};
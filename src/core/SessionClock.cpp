@@ -0,0 +1,82 @@
+#include "SessionClock.h"
+
+//==============================================================================
+void SessionClock::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    streamPosition.store(0);
+    expectedHostPosition = 0;
+    lastHadHostPosition = false;
+    anchorFifo.reset();
+    currentAnchor = {};
+    sessionStartSample.store(0);
+}
+
+void SessionClock::advance(int numSamples, bool hasHostPosition, juce::int64 hostPositionInSamples) noexcept
+{
+    const auto position = streamPosition.load(std::memory_order_relaxed);
+
+    // Only discontinuities need an anchor; in between, host time advances with the samples
+    const auto isDiscontinuity = hasHostPosition != lastHadHostPosition
+        || (hasHostPosition && hostPositionInSamples != expectedHostPosition);
+
+    if (isDiscontinuity)
+    {
+        int start1, size1, start2, size2;
+        anchorFifo.prepareToWrite(1, start1, size1, start2, size2);
+
+        // If the analysis thread has fallen this far behind, later frames keep the previous anchor
+        if (size1 + size2 > 0)
+        {
+            auto& anchor = pendingAnchors[(size_t)(size1 > 0 ? start1 : start2)];
+            anchor.streamSample = position;
+            anchor.hostSample = hostPositionInSamples;
+            anchor.hasHostPosition = hasHostPosition;
+            anchorFifo.finishedWrite(1);
+        }
+    }
+
+    lastHadHostPosition = hasHostPosition;
+    expectedHostPosition = hostPositionInSamples + numSamples;
+    streamPosition.store(position + numSamples, std::memory_order_release);
+}
+
+void SessionClock::startSession()
+{
+    sessionStartMillis.store(juce::Time::currentTimeMillis(), std::memory_order_relaxed);
+    sessionStartSample.store(getStreamPosition(), std::memory_order_release);
+}
+
+double SessionClock::getSessionSeconds() const noexcept
+{
+    return static_cast<double>(getStreamPosition() - getSessionStartSample()) / sampleRate;
+}
+
+SessionClock::Timestamp SessionClock::getTimestamp(juce::int64 streamSample) noexcept
+{
+    // Move to the newest anchor at or before this sample
+    while (anchorFifo.getNumReady() > 0)
+    {
+        int start1, size1, start2, size2;
+        anchorFifo.prepareToRead(1, start1, size1, start2, size2);
+
+        const auto& next = pendingAnchors[(size_t)(size1 > 0 ? start1 : start2)];
+
+        if (next.streamSample > streamSample)
+            break;
+
+        currentAnchor = next;
+        anchorFifo.finishedRead(1);
+    }
+
+    Timestamp timestamp;
+    timestamp.sessionSeconds = static_cast<double>(streamSample - getSessionStartSample()) / sampleRate;
+
+    if (currentAnchor.hasHostPosition)
+    {
+        timestamp.hasHostTime = true;
+        timestamp.hostSeconds = static_cast<double>(currentAnchor.hostSample + (streamSample - currentAnchor.streamSample)) / sampleRate;
+    }
+
+    return timestamp;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <array>
+
+//==============================================================================
+/**
+    Sample-accurate time base for logged sessions.
+
+    Time is counted in samples of the analysed stream rather than read from the wall
+    clock, so it doesn't jitter with the host's block size and stays correct when a host
+    renders faster or slower than real time.
+
+    Each call to advance() may also carry the host's timeline position. Whenever that
+    position is not where the previous block said it would be (transport started,
+    stopped, looped or relocated), a new anchor is queued for the analysis thread, which
+    uses the latest anchor at or before a frame to place it on the host timeline.
+
+    Three threads are involved: the audio thread calls advance(), the message thread
+    starts sessions and reads the elapsed time, and the analysis thread converts frame
+    positions into timestamps.
+*/
+class SessionClock
+{
+public:
+    struct Timestamp
+    {
+        double sessionSeconds = 0.0;    // since startSession(), from the sample count
+        double hostSeconds = 0.0;       // position on the host timeline, if hasHostTime
+        bool hasHostTime = false;
+    };
+
+    SessionClock() = default;
+
+    /** Resets the sample count to zero. Call while neither the audio nor the analysis thread is running. */
+    void prepare(double sampleRate);
+
+    /** Audio thread. Counts a block and, if the host provided one, its timeline position in samples. */
+    void advance(int numSamples, bool hasHostPosition, juce::int64 hostPositionInSamples) noexcept;
+
+    /** Message thread. Makes the current stream position t = 0 and captures the UTC start time. */
+    void startSession();
+
+    /** Samples counted by advance() since prepare(). */
+    juce::int64 getStreamPosition() const noexcept { return streamPosition.load(std::memory_order_acquire); }
+
+    juce::int64 getSessionStartSample() const noexcept { return sessionStartSample.load(std::memory_order_acquire); }
+    juce::Time getSessionStartTime() const noexcept { return juce::Time(sessionStartMillis.load(std::memory_order_relaxed)); }
+
+    /** Seconds of audio since startSession(), independent of how fast the host is running. */
+    double getSessionSeconds() const noexcept;
+
+    /**
+        Analysis thread. Converts a stream position into session and host time. Positions
+        must not decrease between calls, since anchors are consumed as they are passed.
+    */
+    Timestamp getTimestamp(juce::int64 streamSample) noexcept;
+
+private:
+    struct Anchor
+    {
+        juce::int64 streamSample = 0;
+        juce::int64 hostSample = 0;
+        bool hasHostPosition = false;
+    };
+
+    static constexpr int maxPendingAnchors = 64;
+
+    double sampleRate = 44100.0;
+
+    // Audio thread
+    std::atomic<juce::int64> streamPosition{ 0 };
+    juce::int64 expectedHostPosition = 0;
+    bool lastHadHostPosition = false;
+
+    // Audio thread to analysis thread
+    juce::AbstractFifo anchorFifo{ maxPendingAnchors };
+    std::array<Anchor, (size_t)maxPendingAnchors> pendingAnchors;
+
+    // Analysis thread
+    Anchor currentAnchor;
+
+    std::atomic<juce::int64> sessionStartSample{ 0 };
+    std::atomic<juce::int64> sessionStartMillis{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SessionClock)
+};
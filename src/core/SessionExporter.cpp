@@ -0,0 +1,324 @@
+#include "SessionExporter.h"
+#include "OctaveBandAnalyzer.h"
+#include <charconv>
+#include <cmath>
+#include <tuple>
+
+namespace
+{
+    char* appendFixed(char* dest, char* end, double value, int decimals) noexcept
+    {
+        auto result = std::to_chars(dest, end, value, std::chars_format::fixed, decimals);
+        return result.ec == std::errc() ? result.ptr : dest;
+    }
+
+    char* appendFixed(char* dest, char* end, float value, int decimals) noexcept
+    {
+        auto result = std::to_chars(dest, end, value, std::chars_format::fixed, decimals);
+        return result.ec == std::errc() ? result.ptr : dest;
+    }
+
+    char* appendFixed(char* dest, char* end, int value, int) noexcept
+    {
+        auto result = std::to_chars(dest, end, value);
+        return result.ec == std::errc() ? result.ptr : dest;
+    }
+}
+
+//==============================================================================
+SessionExporter::SessionExporter()
+    : juce::Thread("Session Export")
+{
+}
+
+SessionExporter::~SessionExporter()
+{
+    cancel();
+}
+
+bool SessionExporter::start(DataLogger::Snapshot snapshotToWrite, const juce::File& destinationFile, Format formatToWrite)
+{
+    if (isRunning())
+        return false;
+
+    // Make sure the previous thread has fully exited before reusing the members
+    stopThread(-1);
+
+    snapshot = std::move(snapshotToWrite);
+    numRows = snapshot.numPoints;
+    destination = destinationFile;
+    format = formatToWrite;
+    errorMessage.clear();
+    progress.store(0.0);
+    state.store(State::running);
+
+    startThread();
+    return true;
+}
+
+SessionExporter::Format SessionExporter::getFormatForFile(const juce::File& file)
+{
+    return file.hasFileExtension("aas") ? Format::binarySession : Format::csv;
+}
+
+void SessionExporter::cancel()
+{
+    stopThread(-1);
+}
+
+const juce::String& SessionExporter::getCSVHeader()
+{
+    static const auto header = []
+        {
+            juce::String text = "Timestamp_Seconds,Host_Time_Seconds,UTC_Seconds,Stream,Activation_Score,Spectral_Centroid,Spectral_Harshness,Dynamic_Variability,"
+                                "Temporal_Unpredictability,RMS_Level,Spectral_Spread_Hz,Spectral_Rolloff_Hz,Spectral_Flatness,"
+                                "Spectral_Entropy,Sharpness_acum,Roughness_asper,Loudness_sone,Loudness_Level_phon,Loudness_N5_sone,Loudness_N10_sone,"
+                                "Tonal_Frequency_Hz,Tone_To_Noise_dB,Prominence_Ratio_dB,Tonal_Components,Momentary_LUFS,Short_Term_LUFS,Integrated_LUFS,Loudness_Range_LU,"
+                                "LCpeak,LZpeak";
+
+            for (auto& name : DataPoint::getLeqColumnNames())
+                text << "," << name;
+
+            text << ",LAF,LAS,LAI,LAFmax,LASmax,LAImax";
+
+            for (auto& name : DataPoint::getTimescaleColumnNames())
+                text << "," << name;
+
+            for (int band = 0; band < OctaveBandAnalyzer::numThirdOctaveBands; ++band)
+                text << ",Third_Octave_" << OctaveBandAnalyzer::getThirdOctaveName(band) << "Hz";
+
+            for (int band = 0; band < OctaveBandAnalyzer::numOctaveBands; ++band)
+                text << ",Octave_" << OctaveBandAnalyzer::getOctaveName(band) << "Hz";
+
+            for (size_t i = 1; i <= std::tuple_size<decltype(DataPoint::mfcc)>::value; ++i)
+                text << ",MFCC_" << (int)i;
+
+            return text + "\n";
+        }();
+
+    return header;
+}
+
+int SessionExporter::formatCSVRow(const DataPoint& point, double sessionStartSeconds, char* buffer, int bufferSize) noexcept
+{
+    auto* end = buffer + bufferSize;
+    auto* p = buffer;
+
+    auto field = [&p, end](auto value, int decimals, char separator)
+        {
+            p = appendFixed(p, end, value, decimals);
+
+            if (p < end)
+                *p++ = separator;
+        };
+
+    // Optional values are left empty rather than written as nan or 0
+    auto optionalField = [&p, end, &field](double value, bool isValid, int decimals)
+        {
+            if (isValid)
+                field(value, decimals, ',');
+            else if (p < end)
+                *p++ = ',';
+        };
+
+    field(point.timestamp, 6, ',');
+    optionalField(point.hostTime, !std::isnan(point.hostTime), 6);
+    optionalField(sessionStartSeconds + point.timestamp, sessionStartSeconds > 0.0, 3);
+    field(point.stream, 0, ',');
+    field(point.activationScore, 2, ',');
+    field(point.spectralCentroid, 4, ',');
+    field(point.spectralHarshness, 4, ',');
+    field(point.dynamicVariability, 4, ',');
+    field(point.temporalUnpredictability, 4, ',');
+    field(point.rmsLevel, 6, ',');
+    field(point.spectralSpread, 1, ',');
+    field(point.spectralRolloff, 1, ',');
+    field(point.spectralFlatness, 4, ',');
+    field(point.spectralEntropy, 4, ',');
+    field(point.sharpness, 3, ',');
+    field(point.roughness, 3, ',');
+    field(point.loudnessSones, 3, ',');
+    field(point.loudnessPhons, 2, ',');
+    field(point.loudnessN5, 3, ',');
+    field(point.loudnessN10, 3, ',');
+    field(point.tonalFrequency, 1, ',');
+    field(point.toneToNoiseRatio, 2, ',');
+    field(point.prominenceRatio, 2, ',');
+    field(point.numTonalComponents, 0, ',');
+    field(point.momentaryLoudness, 2, ',');
+    field(point.shortTermLoudness, 2, ',');
+    field(point.integratedLoudness, 2, ',');
+    field(point.loudnessRange, 2, ',');
+    field(point.cWeightedPeak, 2, ',');
+    field(point.zWeightedPeak, 2, ',');
+
+    for (const auto* levels : { &point.aWeightedLeq, &point.cWeightedLeq, &point.zWeightedLeq })
+        for (auto level : *levels)
+            field(level, 2, ',');
+
+    for (const auto* levels : { &point.aWeightedLevels, &point.aWeightedMaxLevels })
+        for (auto level : *levels)
+            field(level, 2, ',');
+
+    for (const auto* values : { &point.dynamicVariabilityByTimescale, &point.temporalUnpredictabilityByTimescale })
+        for (auto value : *values)
+            field(value, 4, ',');
+
+    for (auto level : point.thirdOctaveLevels)
+        field(level, 1, ',');
+
+    for (auto level : point.octaveLevels)
+        field(level, 1, ',');
+
+    for (size_t i = 0; i < point.mfcc.size(); ++i)
+        field(point.mfcc[i], 4, i + 1 < point.mfcc.size() ? ',' : '\n');
+
+    return static_cast<int>(p - buffer);
+}
+
+void SessionExporter::run()
+{
+    const auto result = writeFile();
+
+    // Release the chunks as soon as we're done with them; numRows still reports their count
+    snapshot = {};
+    state.store(result);
+}
+
+juce::File SessionExporter::getPercentileFile(const juce::File& sessionFile)
+{
+    return sessionFile.getSiblingFile(sessionFile.getFileNameWithoutExtension() + "_percentiles.csv");
+}
+
+SessionExporter::State SessionExporter::writeFile()
+{
+    juce::TemporaryFile tempFile(destination);
+    juce::TemporaryFile percentileTempFile(getPercentileFile(destination));
+    percentiles.clear();
+
+    {
+        juce::FileOutputStream stream(tempFile.getFile(), streamBufferSize);
+
+        if (!stream.openedOk())
+        {
+            errorMessage = stream.getStatus().getErrorMessage();
+            return State::failed;
+        }
+
+        const auto result = format == Format::binarySession ? writeBinarySession(stream) : writeCSV(stream);
+
+        if (result != State::succeeded)
+            return result;
+
+        stream.flush();
+
+        if (stream.getStatus().failed())
+        {
+            errorMessage = stream.getStatus().getErrorMessage();
+            return State::failed;
+        }
+    }
+
+    if (!writePercentiles(percentileTempFile.getFile()) || !tempFile.overwriteTargetFileWithTemporary())
+    {
+        errorMessage = "Failed to write file. Check permissions.";
+        return State::failed;
+    }
+
+    // The session is already in place, so say exactly what is missing
+    if (!percentileTempFile.overwriteTargetFileWithTemporary())
+    {
+        errorMessage = "The session was saved, but " + getPercentileFile(destination).getFileName() + " could not be written.";
+        return State::failed;
+    }
+
+    progress.store(1.0);
+    return State::succeeded;
+}
+
+SessionExporter::State SessionExporter::writeCSV(juce::OutputStream& stream)
+{
+    stream.writeText(getCSVHeader(), false, false, nullptr);
+
+    char row[2048];
+    int rowsWritten = 0;
+    bool cancelled = false;
+    const auto sessionStartSeconds = static_cast<double>(snapshot.sessionStartMillis) / 1000.0;
+
+    snapshot.forEachPoint([&](const DataPoint& point)
+        {
+            if (cancelled)
+                return;
+
+            stream.write(row, static_cast<size_t>(formatCSVRow(point, sessionStartSeconds, row, static_cast<int>(sizeof(row)))));
+            percentiles[point.stream].add(point);
+            updateProgress(++rowsWritten, cancelled);
+        });
+
+    return cancelled || threadShouldExit() ? State::cancelled : State::succeeded;
+}
+
+SessionExporter::State SessionExporter::writeBinarySession(juce::OutputStream& stream)
+{
+    SessionFileWriter writer(stream);
+    writer.setSessionStartTime(snapshot.sessionStartMillis);
+    int rowsWritten = 0;
+    bool cancelled = false;
+    bool ok = true;
+
+    snapshot.forEachPoint([&](const DataPoint& point)
+        {
+            if (cancelled || !ok)
+                return;
+
+            ok = writer.addPoint(point);
+            percentiles[point.stream].add(point);
+            updateProgress(++rowsWritten, cancelled);
+        });
+
+    if (cancelled || threadShouldExit())
+        return State::cancelled;
+
+    if (!ok || !writer.finish())
+    {
+        errorMessage = "Failed to write session file.";
+        return State::failed;
+    }
+
+    return State::succeeded;
+}
+
+bool SessionExporter::writePercentiles(const juce::File& file)
+{
+    juce::String text = "Stream,Feature,Frames";
+
+    for (int p = 0; p < SessionStatistics::numPercentiles; ++p)
+        text << "," << SessionStatistics::getPercentileName(p);
+
+    text << "\n";
+
+    for (const auto& [stream, statistics] : percentiles)
+    {
+        for (int f = 0; f < SessionStatistics::numFeatures; ++f)
+        {
+            text << stream << "," << SessionStatistics::getFeatureName(static_cast<SessionStatistics::Feature>(f))
+                 << "," << juce::String(statistics.getNumFrames());
+
+            for (int p = 0; p < SessionStatistics::numPercentiles; ++p)
+                text << "," << juce::String(statistics.getPercentile(f, p), 4);
+
+            text << "\n";
+        }
+    }
+
+    return file.replaceWithText(text);
+}
+
+void SessionExporter::updateProgress(int rowsWritten, bool& cancelled)
+{
+    if (rowsWritten % progressInterval != 0)
+        return;
+
+    progress.store(static_cast<double>(rowsWritten) / numRows, std::memory_order_relaxed);
+    cancelled = threadShouldExit();
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "DataLogger.h"
+#include "SessionFile.h"
+#include "SessionStatistics.h"
+#include <map>
+
+//==============================================================================
+/**
+    Writes a DataLogger snapshot to disk on a background thread, either as CSV or as a
+    binary columnar session file (see SessionFormat).
+
+    CSV rows are formatted with std::to_chars into a small stack buffer. Either way the
+    output is streamed through a buffered FileOutputStream into a temporary file, which
+    replaces the destination only once every row has been written. Progress can be
+    polled from any thread and the export can be cancelled at any point, leaving the
+    destination untouched.
+
+    Alongside the session, a <name>_percentiles.csv holds the L10 to L95 of every
+    SessionStatistics feature per stream, built while the rows stream past. It goes to
+    a temporary file of its own, and neither file is replaced until both are written.
+*/
+class SessionExporter : private juce::Thread
+{
+public:
+    enum class State
+    {
+        idle,
+        running,
+        succeeded,
+        failed,
+        cancelled
+    };
+
+    enum class Format
+    {
+        csv,
+        binarySession
+    };
+
+    SessionExporter();
+    ~SessionExporter() override;
+
+    /** Returns false if an export is already running. */
+    bool start(DataLogger::Snapshot snapshotToWrite, const juce::File& destinationFile, Format formatToWrite);
+
+    /** Picks the format from the file extension: .aas is a binary session, anything else CSV. */
+    static Format getFormatForFile(const juce::File& file);
+
+    /** Stops a running export and waits for the thread to finish. */
+    void cancel();
+
+    State getState() const noexcept { return state.load(); }
+    bool isRunning() const noexcept { return getState() == State::running; }
+
+    /** 0-1 while running. */
+    double getProgress() const noexcept { return progress.load(std::memory_order_relaxed); }
+
+    /** Rows in the current or last export. Kept apart from the snapshot, which is released as soon as the export ends. */
+    int getNumRows() const noexcept { return numRows; }
+    juce::File getDestination() const { return destination; }
+
+    /** Valid once the state is failed. */
+    juce::String getErrorMessage() const { return errorMessage; }
+
+    static const juce::String& getCSVHeader();
+
+    /**
+        Formats one CSV row, including the trailing newline, and returns the number of
+        characters written. sessionStartSeconds is the UTC start time in seconds since 1970,
+        or 0 to leave the UTC column empty.
+    */
+    static int formatCSVRow(const DataPoint& point, double sessionStartSeconds, char* buffer, int bufferSize) noexcept;
+
+    /** Where the percentile summary of an export to the given file goes. */
+    static juce::File getPercentileFile(const juce::File& sessionFile);
+
+private:
+    void run() override;
+    State writeFile();
+    State writeCSV(juce::OutputStream& stream);
+    State writeBinarySession(juce::OutputStream& stream);
+    bool writePercentiles(const juce::File& file);
+    void updateProgress(int rowsWritten, bool& cancelled);
+
+    static constexpr size_t streamBufferSize = 1 << 20;
+    static constexpr int progressInterval = 4096; // rows between progress updates and cancel checks
+
+    DataLogger::Snapshot snapshot;
+    juce::File destination;
+    Format format = Format::csv;
+    int numRows = 0;                                  // outlives the snapshot for getNumRows()
+    juce::String errorMessage;
+    std::map<int, SessionStatistics> percentiles;     // per stream
+
+    std::atomic<State> state{ State::idle };
+    std::atomic<double> progress{ 0.0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SessionExporter)
+};
@@ -0,0 +1,412 @@
+#include "SessionFile.h"
+#include "OctaveBandAnalyzer.h"
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+
+namespace
+{
+    using SessionFormat::ColumnType;
+
+    // One column per DataPoint field. The timestamp must stay first: the time index is built from it.
+    struct ColumnDefinition
+    {
+        juce::String name;
+        ColumnType type;
+        size_t offset;
+    };
+
+    std::vector<ColumnDefinition> createDataPointColumns()
+    {
+        std::vector<ColumnDefinition> columns = {
+            { "Timestamp_Seconds",         ColumnType::float64, offsetof(DataPoint, timestamp) },
+            { "Host_Time_Seconds",         ColumnType::float64, offsetof(DataPoint, hostTime) },
+            { "Stream",                    ColumnType::int32,   offsetof(DataPoint, stream) },
+            { "Activation_Score",          ColumnType::float32, offsetof(DataPoint, activationScore) },
+            { "Spectral_Centroid",         ColumnType::float32, offsetof(DataPoint, spectralCentroid) },
+            { "Spectral_Harshness",        ColumnType::float32, offsetof(DataPoint, spectralHarshness) },
+            { "Dynamic_Variability",       ColumnType::float32, offsetof(DataPoint, dynamicVariability) },
+            { "Temporal_Unpredictability", ColumnType::float32, offsetof(DataPoint, temporalUnpredictability) },
+            { "RMS_Level",                 ColumnType::float32, offsetof(DataPoint, rmsLevel) },
+            { "Spectral_Spread_Hz",        ColumnType::float32, offsetof(DataPoint, spectralSpread) },
+            { "Spectral_Rolloff_Hz",       ColumnType::float32, offsetof(DataPoint, spectralRolloff) },
+            { "Spectral_Flatness",         ColumnType::float32, offsetof(DataPoint, spectralFlatness) },
+            { "Spectral_Entropy",          ColumnType::float32, offsetof(DataPoint, spectralEntropy) },
+            { "Sharpness_acum",            ColumnType::float32, offsetof(DataPoint, sharpness) },
+            { "Roughness_asper",           ColumnType::float32, offsetof(DataPoint, roughness) },
+            { "Loudness_sone",             ColumnType::float32, offsetof(DataPoint, loudnessSones) },
+            { "Loudness_Level_phon",       ColumnType::float32, offsetof(DataPoint, loudnessPhons) },
+            { "Loudness_N5_sone",          ColumnType::float32, offsetof(DataPoint, loudnessN5) },
+            { "Loudness_N10_sone",         ColumnType::float32, offsetof(DataPoint, loudnessN10) },
+            { "Tonal_Frequency_Hz",        ColumnType::float32, offsetof(DataPoint, tonalFrequency) },
+            { "Tone_To_Noise_dB",          ColumnType::float32, offsetof(DataPoint, toneToNoiseRatio) },
+            { "Prominence_Ratio_dB",       ColumnType::float32, offsetof(DataPoint, prominenceRatio) },
+            { "Tonal_Components",          ColumnType::int32,   offsetof(DataPoint, numTonalComponents) },
+            { "Momentary_LUFS",            ColumnType::float32, offsetof(DataPoint, momentaryLoudness) },
+            { "Short_Term_LUFS",           ColumnType::float32, offsetof(DataPoint, shortTermLoudness) },
+            { "Integrated_LUFS",           ColumnType::float32, offsetof(DataPoint, integratedLoudness) },
+            { "Loudness_Range_LU",         ColumnType::float32, offsetof(DataPoint, loudnessRange) },
+            { "LCpeak",                    ColumnType::float32, offsetof(DataPoint, cWeightedPeak) },
+            { "LZpeak",                    ColumnType::float32, offsetof(DataPoint, zWeightedPeak) },
+        };
+
+        // Array fields, one column per element
+        auto addArray = [&columns](size_t offset, size_t size, auto&& getName)
+            {
+                for (size_t i = 0; i < size; ++i)
+                    columns.push_back({ getName(static_cast<int>(i)), ColumnType::float32, offset + i * sizeof(float) });
+            };
+
+        // One Leq column per SoundLevelMeter period: LAeq_1s, LAeq_1min...
+        const auto& leqNames = DataPoint::getLeqColumnNames();
+        constexpr auto numPeriods = std::tuple_size<decltype(DataPoint::aWeightedLeq)>::value;
+
+        auto addLeqs = [&](size_t offset, int weighting)
+            {
+                addArray(offset, numPeriods, [&](int period) { return leqNames[weighting * (int)numPeriods + period]; });
+            };
+
+        addLeqs(offsetof(DataPoint, aWeightedLeq), 0);
+        addLeqs(offsetof(DataPoint, cWeightedLeq), 1);
+        addLeqs(offsetof(DataPoint, zWeightedLeq), 2);
+
+        const char* const timeWeightingNames[] = { "LAF", "LAS", "LAI" };
+        addArray(offsetof(DataPoint, aWeightedLevels), std::size(timeWeightingNames),
+                 [&](int mode) { return juce::String(timeWeightingNames[mode]); });
+        addArray(offsetof(DataPoint, aWeightedMaxLevels), std::size(timeWeightingNames),
+                 [&](int mode) { return juce::String(timeWeightingNames[mode]) + "max"; });
+
+        // One column per dynamics timescale: Dynamic_Variability_1s, Dynamic_Variability_10s...
+        const auto& timescaleNames = DataPoint::getTimescaleColumnNames();
+        constexpr auto numTimescales = std::tuple_size<decltype(DataPoint::dynamicVariabilityByTimescale)>::value;
+
+        auto addTimescales = [&](size_t offset, int feature)
+            {
+                addArray(offset, numTimescales, [&](int timescale) { return timescaleNames[feature * (int)numTimescales + timescale]; });
+            };
+
+        addTimescales(offsetof(DataPoint, dynamicVariabilityByTimescale), 0);
+        addTimescales(offsetof(DataPoint, temporalUnpredictabilityByTimescale), 1);
+        addArray(offsetof(DataPoint, thirdOctaveLevels), std::tuple_size<decltype(DataPoint::thirdOctaveLevels)>::value,
+                 [](int band) { return "Third_Octave_" + juce::String(OctaveBandAnalyzer::getThirdOctaveName(band)) + "Hz"; });
+        addArray(offsetof(DataPoint, octaveLevels), std::tuple_size<decltype(DataPoint::octaveLevels)>::value,
+                 [](int band) { return "Octave_" + juce::String(OctaveBandAnalyzer::getOctaveName(band)) + "Hz"; });
+        addArray(offsetof(DataPoint, mfcc), std::tuple_size<decltype(DataPoint::mfcc)>::value,
+                 [](int coefficient) { return "MFCC_" + juce::String(coefficient + 1); });
+
+        return columns;
+    }
+
+    const std::vector<ColumnDefinition>& getDataPointColumns()
+    {
+        static const auto columns = createDataPointColumns();
+        return columns;
+    }
+
+    juce::uint32 getElementSize(ColumnType type) noexcept
+    {
+        return type == ColumnType::float64 ? 8 : 4;
+    }
+
+    /** True if count entries of entrySize bytes from offset lie inside the file. Can't overflow, whatever a corrupt header holds. */
+    bool fitsInFile(juce::uint64 offset, juce::uint64 count, juce::uint64 entrySize, juce::uint64 fileSize) noexcept
+    {
+        return offset <= fileSize && count <= (fileSize - offset) / entrySize;
+    }
+}
+
+//==============================================================================
+SessionFileWriter::SessionFileWriter(juce::OutputStream& destination, int rowsPerChunkToUse)
+    : stream(destination),
+    rowsPerChunk(juce::jmax(1, rowsPerChunkToUse))
+{
+    pendingRows.reserve((size_t)rowsPerChunk);
+    segment.resize((size_t)SessionFormat::getSegmentSize(8, (juce::uint32)rowsPerChunk));
+
+    // Placeholder; finish() fills in the counts and offsets
+    writeHeader();
+}
+
+bool SessionFileWriter::addPoint(const DataPoint& point)
+{
+    pendingRows.push_back(point);
+    ++numRows;
+
+    return (int)pendingRows.size() < rowsPerChunk || writeChunk();
+}
+
+bool SessionFileWriter::finish()
+{
+    if (!pendingRows.empty() && !writeChunk())
+        return false;
+
+    const auto columnDirectoryOffset = static_cast<juce::uint64>(stream.getPosition());
+
+    for (const auto& definition : getDataPointColumns())
+    {
+        SessionFormat::ColumnEntry entry{};
+        std::strncpy(entry.name, definition.name.toRawUTF8(), sizeof(entry.name) - 1);
+        entry.type = definition.type;
+        entry.elementSize = getElementSize(definition.type);
+
+        if (!stream.write(&entry, sizeof(entry)))
+            return false;
+    }
+
+    const auto chunkIndexOffset = static_cast<juce::uint64>(stream.getPosition());
+
+    if (!chunkIndex.empty() && !stream.write(chunkIndex.data(), chunkIndex.size() * sizeof(SessionFormat::ChunkEntry)))
+        return false;
+
+    SessionFormat::Header header{};
+    std::memcpy(header.magic, SessionFormat::magic, sizeof(header.magic));
+    header.version = SessionFormat::currentVersion;
+    header.headerSize = sizeof(SessionFormat::Header);
+    header.numColumns = (juce::uint32)getDataPointColumns().size();
+    header.rowsPerChunk = (juce::uint32)rowsPerChunk;
+    header.numRows = (juce::uint64)numRows;
+    header.columnDirectoryOffset = columnDirectoryOffset;
+    header.chunkIndexOffset = chunkIndexOffset;
+    header.numChunks = (juce::uint32)chunkIndex.size();
+    header.sessionStartMillis = sessionStartMillis;
+
+    const auto end = stream.getPosition();
+
+    if (!stream.setPosition(0) || !stream.write(&header, sizeof(header)) || !stream.setPosition(end))
+        return false;
+
+    stream.flush();
+    return true;
+}
+
+bool SessionFileWriter::writeHeader()
+{
+    SessionFormat::Header header{};
+    std::memcpy(header.magic, SessionFormat::magic, sizeof(header.magic));
+    header.version = SessionFormat::currentVersion;
+    header.headerSize = sizeof(SessionFormat::Header);
+
+    return stream.write(&header, sizeof(header)) && writePadding();
+}
+
+bool SessionFileWriter::writeChunk()
+{
+    const auto numChunkRows = (juce::uint32)pendingRows.size();
+
+    SessionFormat::ChunkEntry entry{};
+    entry.fileOffset = static_cast<juce::uint64>(stream.getPosition());
+    entry.firstRow = static_cast<juce::uint64>(numRows) - numChunkRows;
+    entry.numRows = numChunkRows;
+    entry.firstTimestamp = pendingRows.front().timestamp;
+    entry.lastTimestamp = pendingRows.back().timestamp;
+
+    // Gather each field into a contiguous segment
+    for (const auto& definition : getDataPointColumns())
+    {
+        const auto elementSize = getElementSize(definition.type);
+        auto* dest = segment.data();
+
+        for (const auto& row : pendingRows)
+        {
+            std::memcpy(dest, reinterpret_cast<const char*>(&row) + definition.offset, elementSize);
+            dest += elementSize;
+        }
+
+        if (!stream.write(segment.data(), (size_t)elementSize * numChunkRows) || !writePadding())
+            return false;
+    }
+
+    chunkIndex.push_back(entry);
+    pendingRows.clear();
+    return true;
+}
+
+bool SessionFileWriter::writePadding()
+{
+    static const char zeros[SessionFormat::segmentAlignment] = {};
+    const auto misalignment = static_cast<juce::uint32>(stream.getPosition() % SessionFormat::segmentAlignment);
+
+    return misalignment == 0 || stream.write(zeros, SessionFormat::segmentAlignment - misalignment);
+}
+
+//==============================================================================
+SessionFileReader::SessionFileReader(const juce::File& file)
+    : mappedFile(std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly))
+{
+    data = static_cast<const char*>(mappedFile->getData());
+    size = static_cast<juce::uint64>(mappedFile->getSize());
+
+    if (data == nullptr)
+        error = "Cannot map " + file.getFullPathName();
+    else if (!validate())
+        header = nullptr;
+}
+
+bool SessionFileReader::validate()
+{
+    if (size < sizeof(SessionFormat::Header))
+    {
+        error = "File is too small to be a session";
+        return false;
+    }
+
+    header = reinterpret_cast<const SessionFormat::Header*>(data);
+
+    if (std::memcmp(header->magic, SessionFormat::magic, sizeof(header->magic)) != 0)
+    {
+        error = "Not a session file";
+        return false;
+    }
+
+    if (header->version > SessionFormat::currentVersion || header->headerSize < sizeof(SessionFormat::Header))
+    {
+        error = "Unsupported session version " + juce::String(header->version);
+        return false;
+    }
+
+    if (header->numColumns == 0
+        || !fitsInFile(header->columnDirectoryOffset, header->numColumns, sizeof(SessionFormat::ColumnEntry), size)
+        || !fitsInFile(header->chunkIndexOffset, header->numChunks, sizeof(SessionFormat::ChunkEntry), size))
+    {
+        error = "Session file is truncated";
+        return false;
+    }
+
+    // The directory and index are read in place, so they must be aligned for their types
+    if (header->columnDirectoryOffset % alignof(SessionFormat::ColumnEntry) != 0
+        || header->chunkIndexOffset % alignof(SessionFormat::ChunkEntry) != 0
+        || header->rowsPerChunk == 0)
+    {
+        error = "Corrupt session header";
+        return false;
+    }
+
+    columns = reinterpret_cast<const SessionFormat::ColumnEntry*>(data + header->columnDirectoryOffset);
+    chunkIndex = reinterpret_cast<const SessionFormat::ChunkEntry*>(data + header->chunkIndexOffset);
+
+    for (juce::uint32 i = 0; i < header->numColumns; ++i)
+    {
+        if (columns[i].elementSize != getElementSize(columns[i].type))
+        {
+            error = "Corrupt column directory";
+            return false;
+        }
+    }
+
+    if (columns[0].type != ColumnType::float64)
+    {
+        error = "First column must be the timestamp";
+        return false;
+    }
+
+    // getValue() finds a row's chunk as row / rowsPerChunk, so the chunks must follow on
+    // from each other and every one but the last must be full
+    juce::uint64 numRowsIndexed = 0;
+
+    for (juce::uint32 i = 0; i < header->numChunks; ++i)
+    {
+        const auto& chunk = chunkIndex[i];
+        const auto isLastChunk = i + 1 == header->numChunks;
+
+        if (chunk.firstRow != numRowsIndexed
+            || chunk.numRows > header->rowsPerChunk
+            || (!isLastChunk && chunk.numRows != header->rowsPerChunk)
+            || chunk.fileOffset % SessionFormat::segmentAlignment != 0)
+        {
+            error = "Corrupt chunk index";
+            return false;
+        }
+
+        numRowsIndexed += chunk.numRows;
+
+        if (chunk.fileOffset > size)
+        {
+            error = "Session file is truncated";
+            return false;
+        }
+
+        auto bytesLeft = size - chunk.fileOffset;
+
+        for (juce::uint32 c = 0; c < header->numColumns; ++c)
+        {
+            const auto segmentSize = SessionFormat::getSegmentSize(columns[c].elementSize, chunk.numRows);
+
+            if (segmentSize > bytesLeft)
+            {
+                error = "Session file is truncated";
+                return false;
+            }
+
+            bytesLeft -= segmentSize;
+        }
+    }
+
+    if (numRowsIndexed != header->numRows)
+    {
+        error = "Corrupt chunk index";
+        return false;
+    }
+
+    return true;
+}
+
+juce::String SessionFileReader::getColumnName(int column) const
+{
+    const auto& name = columns[column].name;
+    return juce::String(name, strnlen(name, sizeof(name)));
+}
+
+int SessionFileReader::findColumn(const juce::String& name) const
+{
+    for (int i = 0; i < getNumColumns(); ++i)
+        if (getColumnName(i) == name)
+            return i;
+
+    return -1;
+}
+
+const char* SessionFileReader::getSegment(int column, int chunk) const noexcept
+{
+    const auto& entry = chunkIndex[chunk];
+    auto offset = entry.fileOffset;
+
+    for (int c = 0; c < column; ++c)
+        offset += SessionFormat::getSegmentSize(columns[c].elementSize, entry.numRows);
+
+    return data + offset;
+}
+
+double SessionFileReader::getValue(int column, juce::int64 row) const noexcept
+{
+    const auto chunk = static_cast<int>(row / header->rowsPerChunk);
+    const auto index = static_cast<size_t>(row - static_cast<juce::int64>(chunkIndex[chunk].firstRow));
+
+    switch (columns[column].type)
+    {
+        case ColumnType::float64: return getColumnData<double>(column, chunk)[index];
+        case ColumnType::int32:   return getColumnData<juce::int32>(column, chunk)[index];
+        case ColumnType::float32: break;
+    }
+
+    return getColumnData<float>(column, chunk)[index];
+}
+
+juce::int64 SessionFileReader::findRowAtTime(double seconds) const noexcept
+{
+    const auto* begin = chunkIndex;
+    const auto* end = chunkIndex + getNumChunks();
+
+    // First chunk that ends at or after the requested time
+    const auto* chunk = std::lower_bound(begin, end, seconds, [](const SessionFormat::ChunkEntry& entry, double time)
+        {
+            return entry.lastTimestamp < time;
+        });
+
+    if (chunk == end)
+        return getNumRows();
+
+    const auto* timestamps = getColumnData<double>(0, static_cast<int>(chunk - begin));
+    const auto* row = std::lower_bound(timestamps, timestamps + chunk->numRows, seconds);
+
+    return static_cast<juce::int64>(chunk->firstRow) + (row - timestamps);
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "DataLogger.h"
+
+//==============================================================================
+/**
+    Binary columnar session format (.aas).
+
+    Layout, all offsets from the start of the file:
+
+        Header            64 bytes, fixed
+        Chunk 0..n-1      each holds up to rowsPerChunk rows, stored column by column;
+                          every column segment starts on a 64-byte boundary
+        Column directory  one ColumnEntry per column
+        Chunk index       one ChunkEntry per chunk, with the time range it covers
+
+    Values are stored in the host's native little-endian layout so that the reader can
+    hand out pointers straight into the memory-mapped file. A downstream tool that only
+    needs one column touches only that column's segments.
+*/
+namespace SessionFormat
+{
+    constexpr char magic[8] = { 'A', 'A', 'S', 'E', 'S', 'S', '\0', '\0' };
+    constexpr juce::uint32 currentVersion = 2;     // 2: int32 columns (the Stream column)
+    constexpr juce::uint32 segmentAlignment = 64;
+    constexpr int defaultRowsPerChunk = 16384;
+
+    enum class ColumnType : juce::uint32
+    {
+        float32 = 0,
+        float64 = 1,
+        int32 = 2
+    };
+
+    struct Header
+    {
+        char magic[8];
+        juce::uint32 version;
+        juce::uint32 headerSize;
+        juce::uint32 numColumns;
+        juce::uint32 rowsPerChunk;
+        juce::uint64 numRows;
+        juce::uint64 columnDirectoryOffset;
+        juce::uint64 chunkIndexOffset;
+        juce::uint32 numChunks;
+        juce::uint32 reserved0;
+        juce::int64 sessionStartMillis;     // UTC, milliseconds since 1970; 0 if unknown
+    };
+
+    struct ColumnEntry
+    {
+        char name[40];
+        ColumnType type;
+        juce::uint32 elementSize;
+    };
+
+    struct ChunkEntry
+    {
+        juce::uint64 fileOffset;
+        juce::uint64 firstRow;
+        juce::uint32 numRows;
+        juce::uint32 reserved;
+        double firstTimestamp;
+        double lastTimestamp;
+    };
+
+    static_assert(sizeof(Header) == 64, "Header layout is part of the file format");
+    static_assert(sizeof(ColumnEntry) == 48, "ColumnEntry layout is part of the file format");
+    static_assert(sizeof(ChunkEntry) == 40, "ChunkEntry layout is part of the file format");
+
+    /** Bytes one column occupies inside a chunk of numRows rows, including padding. */
+    inline juce::uint64 getSegmentSize(juce::uint32 elementSize, juce::uint32 numRows) noexcept
+    {
+        const auto size = static_cast<juce::uint64>(elementSize) * numRows;
+        return (size + segmentAlignment - 1) / segmentAlignment * segmentAlignment;
+    }
+}
+
+//==============================================================================
+/**
+    Writes DataPoints as a session file. One column per DataPoint field; rows are
+    buffered and flushed a chunk at a time, and the directory and time index are
+    written by finish().
+*/
+class SessionFileWriter
+{
+public:
+    /** The stream must support setPosition(); finish() rewrites the header in place. */
+    explicit SessionFileWriter(juce::OutputStream& destination, int rowsPerChunk = SessionFormat::defaultRowsPerChunk);
+
+    /** UTC start of the session in milliseconds since 1970, stored in the header. */
+    void setSessionStartTime(juce::int64 utcMillis) noexcept { sessionStartMillis = utcMillis; }
+
+    bool addPoint(const DataPoint& point);
+    bool finish();
+
+    juce::int64 getNumRows() const noexcept { return numRows; }
+
+private:
+    bool writeHeader();
+    bool writeChunk();
+    bool writePadding();
+
+    juce::OutputStream& stream;
+    const int rowsPerChunk;
+
+    std::vector<DataPoint> pendingRows;
+    std::vector<SessionFormat::ChunkEntry> chunkIndex;
+    std::vector<char> segment;
+    juce::int64 numRows = 0;
+    juce::int64 sessionStartMillis = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(SessionFileWriter)
+};
+
+//==============================================================================
+/**
+    Zero-copy reader for session files, backed by a juce::MemoryMappedFile.
+
+    Opening a file only validates the header, directory and index; column data is paged
+    in by the OS when it is first touched.
+*/
+class SessionFileReader
+{
+public:
+    explicit SessionFileReader(const juce::File& file);
+
+    bool isValid() const noexcept { return header != nullptr; }
+    juce::String getError() const { return error; }
+
+    juce::int64 getNumRows() const noexcept { return isValid() ? static_cast<juce::int64>(header->numRows) : 0; }
+    int getNumColumns() const noexcept { return isValid() ? static_cast<int>(header->numColumns) : 0; }
+    int getNumChunks() const noexcept { return isValid() ? static_cast<int>(header->numChunks) : 0; }
+
+    /** UTC start of the session; the epoch if the writer didn't know it. */
+    juce::Time getSessionStartTime() const noexcept { return juce::Time(isValid() ? header->sessionStartMillis : 0); }
+
+    juce::String getColumnName(int column) const;
+    SessionFormat::ColumnType getColumnType(int column) const noexcept { return columns[column].type; }
+
+    /** Returns -1 if there is no column with this name. */
+    int findColumn(const juce::String& name) const;
+
+    const SessionFormat::ChunkEntry& getChunk(int chunk) const noexcept { return chunkIndex[chunk]; }
+
+    /** Pointer into the mapped file for one column of one chunk; getChunk(chunk).numRows values long. */
+    template <typename ValueType>
+    const ValueType* getColumnData(int column, int chunk) const noexcept
+    {
+        jassert(sizeof(ValueType) == columns[column].elementSize);
+        return reinterpret_cast<const ValueType*>(getSegment(column, chunk));
+    }
+
+    /** Reads a single value of any column as a double. */
+    double getValue(int column, juce::int64 row) const noexcept;
+
+    /** First row whose timestamp is at or after the given time, or getNumRows() if none. */
+    juce::int64 findRowAtTime(double seconds) const noexcept;
+
+private:
+    const char* getSegment(int column, int chunk) const noexcept;
+    bool validate();
+
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    const char* data = nullptr;
+    juce::uint64 size = 0;
+
+    const SessionFormat::Header* header = nullptr;
+    const SessionFormat::ColumnEntry* columns = nullptr;
+    const SessionFormat::ChunkEntry* chunkIndex = nullptr;
+    juce::String error;
+
+    JUCE_DECLARE_NON_COPYABLE(SessionFileReader)
+};
@@ -0,0 +1,85 @@
+#include "SessionStatistics.h"
+#include "AcousticAnalysisEngine.h"
+#include "DataLogger.h"
+
+//==============================================================================
+SessionStatistics::SessionStatistics()
+{
+    // Exceeded during x % of the frames is the (100 - x)th percentile
+    for (int f = 0; f < numFeatures; ++f)
+        for (int p = 0; p < numPercentiles; ++p)
+            quantiles[(size_t)(f * numPercentiles + p)].setProbability(1.0 - percentages[(size_t)p] / 100.0);
+}
+
+void SessionStatistics::reset() noexcept
+{
+    for (auto& quantile : quantiles)
+        quantile.reset();
+}
+
+void SessionStatistics::add(const AnalysisFrame& frame) noexcept
+{
+    addValues({ frame.aWeightedLevels[(size_t)TimeWeighting::Mode::fast],
+                frame.acousticActivationScore,
+                frame.spectralCentroid,
+                frame.spectralHarshness,
+                frame.dynamicVariability,
+                frame.temporalUnpredictability,
+                frame.spectralFlatness,
+                frame.spectralEntropy,
+                frame.sharpness,
+                frame.roughness,
+                frame.loudnessSones });
+}
+
+void SessionStatistics::add(const DataPoint& point) noexcept
+{
+    addValues({ point.aWeightedLevels[(size_t)TimeWeighting::Mode::fast],
+                point.activationScore,
+                point.spectralCentroid,
+                point.spectralHarshness,
+                point.dynamicVariability,
+                point.temporalUnpredictability,
+                point.spectralFlatness,
+                point.spectralEntropy,
+                point.sharpness,
+                point.roughness,
+                point.loudnessSones });
+}
+
+void SessionStatistics::addValues(const std::array<float, numFeatures>& values) noexcept
+{
+    for (int f = 0; f < numFeatures; ++f)
+        for (int p = 0; p < numPercentiles; ++p)
+            quantiles[(size_t)(f * numPercentiles + p)].add(values[(size_t)f]);
+}
+
+float SessionStatistics::getPercentile(Feature feature, int percentile) const noexcept
+{
+    return static_cast<float>(quantiles[(size_t)((int)feature * numPercentiles + percentile)].getQuantile());
+}
+
+const char* SessionStatistics::getFeatureName(Feature feature) noexcept
+{
+    switch (feature)
+    {
+        case Feature::level:                    return "LAF";
+        case Feature::activationScore:          return "Activation_Score";
+        case Feature::spectralCentroid:         return "Spectral_Centroid";
+        case Feature::spectralHarshness:        return "Spectral_Harshness";
+        case Feature::dynamicVariability:       return "Dynamic_Variability";
+        case Feature::temporalUnpredictability: return "Temporal_Unpredictability";
+        case Feature::spectralFlatness:         return "Spectral_Flatness";
+        case Feature::spectralEntropy:          return "Spectral_Entropy";
+        case Feature::sharpness:                return "Sharpness_acum";
+        case Feature::roughness:                return "Roughness_asper";
+        case Feature::loudness:                 return "Loudness_sone";
+    }
+
+    return "";
+}
+
+juce::String SessionStatistics::getPercentileName(int percentile)
+{
+    return "L" + juce::String(percentages[(size_t)percentile], 0);
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "StreamingQuantile.h"
+#include <array>
+
+struct AnalysisFrame;
+struct DataPoint;
+
+//==============================================================================
+/**
+    Session percentiles of the per-frame features, in the convention of environmental
+    noise reports: L10 is the value exceeded during 10 % of the frames, L90 the one
+    exceeded during 90 % of them. The level is LAF, so its L10 to L95 are the usual
+    LA10 to LA95.
+
+    Every feature and percentile has its own StreamingQuantile, so memory is constant
+    whether the session lasts ten minutes or ten days. A frame costs a few dozen marker
+    updates and nothing allocates, so the engine keeps one per stream and updates it
+    every frame. add() also takes logged DataPoints, so the exporter rebuilds the same
+    figures from a recording.
+*/
+class SessionStatistics
+{
+public:
+    enum class Feature
+    {
+        level,                      // LAF, dB re full scale
+        activationScore,
+        spectralCentroid,
+        spectralHarshness,
+        dynamicVariability,
+        temporalUnpredictability,
+        spectralFlatness,
+        spectralEntropy,
+        sharpness,
+        roughness,
+        loudness                    // sone
+    };
+
+    static constexpr int numFeatures = 11;
+    static constexpr int numPercentiles = 4;
+
+    /** Percentage of the frames in which each percentile is exceeded: L10, L50, L90, L95. */
+    static constexpr std::array<float, numPercentiles> percentages{ 10.0f, 50.0f, 90.0f, 95.0f };
+
+    SessionStatistics();
+
+    /** Forgets every frame, e.g. when a recording starts. */
+    void reset() noexcept;
+
+    /** Adds one frame's features. Real-time safe. */
+    void add(const AnalysisFrame& frame) noexcept;
+    void add(const DataPoint& point) noexcept;
+
+    /** Adds one value per feature, in the order of Feature. */
+    void addValues(const std::array<float, numFeatures>& values) noexcept;
+
+    /** The value of a feature exceeded during percentages[percentile] % of the frames. */
+    float getPercentile(Feature feature, int percentile) const noexcept;
+    float getPercentile(int feature, int percentile) const noexcept { return getPercentile(static_cast<Feature>(feature), percentile); }
+
+    juce::int64 getNumFrames() const noexcept { return quantiles[0].getCount(); }
+
+    /** Column-style name of a feature, e.g. "Activation_Score". */
+    static const char* getFeatureName(Feature feature) noexcept;
+
+    /** "L10", "L50"... */
+    static juce::String getPercentileName(int percentile);
+
+private:
+    std::array<StreamingQuantile, (size_t)numFeatures * numPercentiles> quantiles;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SessionStatistics)
+};
@@ -0,0 +1,104 @@
+#include "SlidingStatistics.h"
+
+//==============================================================================
+void SlidingStatistics::prepare(const int* windowLengths, int numWindowsToUse)
+{
+    jassert(numWindowsToUse <= maxWindows);
+    numWindows = juce::jlimit(0, maxWindows, numWindowsToUse);
+
+    int longest = 1;
+
+    for (int i = 0; i < numWindows; ++i)
+    {
+        windows[(size_t)i].length = juce::jmax(1, windowLengths[i]);
+        longest = juce::jmax(longest, windows[(size_t)i].length);
+    }
+
+    history.assign((size_t)longest + 1, 0.0f);
+
+    reset();
+}
+
+void SlidingStatistics::reset() noexcept
+{
+    for (auto& window : windows)
+    {
+        window.count = 0;
+        window.mean = 0.0;
+        window.sumOfSquaredDeviations = 0.0;
+        window.sumOfAbsoluteDifferences = 0.0;
+        window.valuesSinceRecalculation = 0;
+    }
+
+    numValues = 0;
+}
+
+void SlidingStatistics::add(float value) noexcept
+{
+    const auto size = static_cast<juce::int64>(history.size());
+    const auto x = static_cast<double>(value);
+    const auto previous = numValues > 0 ? static_cast<double>(history[(size_t)((numValues - 1) % size)]) : 0.0;
+
+    // The slot written is one longer than the longest window ago, so nothing below still needs it
+    history[(size_t)(numValues % size)] = value;
+
+    for (int i = 0; i < numWindows; ++i)
+    {
+        auto& w = windows[(size_t)i];
+
+        if (w.count < w.length)
+        {
+            // Still filling: Welford
+            ++w.count;
+            const auto delta = x - w.mean;
+            w.mean += delta / w.count;
+            w.sumOfSquaredDeviations += delta * (x - w.mean);
+
+            if (w.count > 1)
+                w.sumOfAbsoluteDifferences += std::abs(x - previous);
+        }
+        else if (++w.valuesSinceRecalculation >= w.length)
+        {
+            recalculate(w);
+            w.valuesSinceRecalculation = 0;
+        }
+        else
+        {
+            // Full: x enters, the oldest value y leaves, and with it the pair (y, next)
+            const auto leaving = static_cast<double>(history[(size_t)((numValues - w.length) % size)]);
+            const auto next = static_cast<double>(history[(size_t)((numValues - w.length + 1) % size)]);
+            const auto oldMean = w.mean;
+
+            w.mean += (x - leaving) / w.length;
+            w.sumOfSquaredDeviations = juce::jmax(0.0, w.sumOfSquaredDeviations + (x - leaving) * (x - w.mean + leaving - oldMean));
+            w.sumOfAbsoluteDifferences = juce::jmax(0.0, w.sumOfAbsoluteDifferences + std::abs(x - previous) - std::abs(next - leaving));
+        }
+    }
+
+    ++numValues;
+}
+
+void SlidingStatistics::recalculate(Window& w) const noexcept
+{
+    const auto size = static_cast<juce::int64>(history.size());
+    const auto first = numValues - w.length + 1;
+    auto valueAt = [this, size](juce::int64 index) { return static_cast<double>(history[(size_t)(index % size)]); };
+
+    double sum = 0.0;
+
+    for (auto index = first; index <= numValues; ++index)
+        sum += valueAt(index);
+
+    w.mean = sum / w.length;
+    w.sumOfSquaredDeviations = 0.0;
+    w.sumOfAbsoluteDifferences = 0.0;
+
+    for (auto index = first; index <= numValues; ++index)
+    {
+        const auto deviation = valueAt(index) - w.mean;
+        w.sumOfSquaredDeviations += deviation * deviation;
+
+        if (index > first)
+            w.sumOfAbsoluteDifferences += std::abs(valueAt(index) - valueAt(index - 1));
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <vector>
+
+//==============================================================================
+/**
+    Mean, standard deviation and mean absolute difference of consecutive values of one
+    stream over several trailing windows at once, each updated in O(1) per value.
+
+    Every window keeps a running mean and sum of squared deviations. While it fills they
+    follow Welford's recurrence; once full, the sliding form adds the new value and drops
+    the one leaving in a single correction. A running sum of absolute differences between
+    neighbours is kept the same way. Those corrections would let rounding errors pile up
+    over a long session, so every length values a full window is recomputed from the
+    history instead, which keeps the cost O(1) per value on average. The windows share
+    one history ring as long as the longest, so each value is stored once. Nothing
+    allocates after prepare().
+*/
+class SlidingStatistics
+{
+public:
+    static constexpr int maxWindows = 8;
+
+    SlidingStatistics() = default;
+
+    /** Sets the window lengths, in values, and allocates the history. Not real-time safe. */
+    void prepare(const int* windowLengths, int numWindowsToUse);
+
+    /** Empties every window. */
+    void reset() noexcept;
+
+    /** Appends a value to every window, dropping the oldest from the full ones. Real-time safe. */
+    void add(float value) noexcept;
+
+    int getNumWindows() const noexcept { return numWindows; }
+    int getWindowLength(int window) const noexcept { return windows[(size_t)window].length; }
+
+    /** Values in a window so far, up to its length. */
+    int getCount(int window) const noexcept { return windows[(size_t)window].count; }
+
+    double getMean(int window) const noexcept { return windows[(size_t)window].mean; }
+
+    /** Population variance of the values in a window. */
+    double getVariance(int window) const noexcept
+    {
+        const auto& w = windows[(size_t)window];
+        return w.count > 0 ? juce::jmax(0.0, w.sumOfSquaredDeviations / w.count) : 0.0;
+    }
+
+    double getStandardDeviation(int window) const noexcept { return std::sqrt(getVariance(window)); }
+
+    /** Mean of |x[i] - x[i - 1]| over the neighbouring pairs in a window. */
+    double getMeanAbsoluteDifference(int window) const noexcept
+    {
+        const auto& w = windows[(size_t)window];
+        return w.count > 1 ? juce::jmax(0.0, w.sumOfAbsoluteDifferences / (w.count - 1)) : 0.0;
+    }
+
+private:
+    struct Window
+    {
+        int length = 1;
+        int count = 0;
+        double mean = 0.0;
+        double sumOfSquaredDeviations = 0.0;
+        double sumOfAbsoluteDifferences = 0.0;
+        int valuesSinceRecalculation = 0;
+    };
+
+    /** Recomputes a full window from the history, the newest value included. */
+    void recalculate(Window& window) const noexcept;
+
+    std::array<Window, maxWindows> windows;
+    int numWindows = 0;
+
+    std::vector<float> history;     // longest window + 1, so the pair leaving it is still there
+    juce::int64 numValues = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SlidingStatistics)
+};
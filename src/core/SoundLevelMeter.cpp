@@ -0,0 +1,234 @@
+#include "SoundLevelMeter.h"
+#include <complex>
+
+namespace
+{
+    // IEC 61672-1 weighting poles in Hz
+    constexpr double pole1 = 20.598997;
+    constexpr double pole2 = 107.65265;
+    constexpr double pole3 = 737.86223;
+    constexpr double pole4 = 12194.217;
+
+    constexpr double referenceFrequency = 1000.0;
+
+    /** Pole frequency in rad/s, prewarped so the digital pole lands on the analogue one. */
+    double prewarp(double frequency, double sampleRate) noexcept
+    {
+        return 2.0 * sampleRate * std::tan(juce::MathConstants<double>::pi * juce::jmin(frequency, 0.49 * sampleRate) / sampleRate);
+    }
+}
+
+//==============================================================================
+float SoundLevelMeter::meanSquareToLevel(double meanSquare) noexcept
+{
+    return meanSquare > 0.0 ? static_cast<float>(juce::jmax(static_cast<double>(minimumLevel), 10.0 * std::log10(meanSquare)))
+                            : minimumLevel;
+}
+
+double SoundLevelMeter::getMagnitude(const Biquad& section, double frequency, double sampleRate) noexcept
+{
+    const auto z = std::polar(1.0, -juce::MathConstants<double>::twoPi * frequency / sampleRate);
+    const auto numerator = section.b0 + section.b1 * z + section.b2 * z * z;
+    const auto denominator = 1.0 + section.a1 * z + section.a2 * z * z;
+
+    return std::abs(numerator / denominator);
+}
+
+juce::String SoundLevelMeter::getPeriodName(double seconds)
+{
+    if (seconds <= 0.0)
+        return "Session";
+
+    if (seconds < 60.0)
+        return juce::String(seconds, seconds == std::floor(seconds) ? 0 : 1) + "s";
+
+    if (seconds < 3600.0)
+        return juce::String(seconds / 60.0, std::fmod(seconds, 60.0) == 0.0 ? 0 : 1) + "min";
+
+    return juce::String(seconds / 3600.0, std::fmod(seconds, 3600.0) == 0.0 ? 0 : 1) + "h";
+}
+
+juce::StringArray SoundLevelMeter::getEquivalentLevelNames(const Options& options)
+{
+    juce::StringArray names;
+
+    for (auto prefix : { "LAeq_", "LCeq_", "LZeq_" })
+        for (auto period : options.periods)
+            names.add(prefix + getPeriodName(period));
+
+    return names;
+}
+
+//==============================================================================
+void SoundLevelMeter::prepare(double sampleRate, const Options& optionsToUse)
+{
+    options = optionsToUse;
+    currentSampleRate = sampleRate;
+
+    // Analogue (b0 s^2 + b1 s + b2) / (s^2 + a1 s + a2) through s = k (1 - z^-1) / (1 + z^-1)
+    const auto k = 2.0 * sampleRate;
+
+    auto bilinear = [k](double b0, double b1, double b2, double a1, double a2)
+        {
+            const auto norm = 1.0 / (k * k + a1 * k + a2);
+
+            Biquad section;
+            section.b0 = (b0 * k * k + b1 * k + b2) * norm;
+            section.b1 = 2.0 * (b2 - b0 * k * k) * norm;
+            section.b2 = (b0 * k * k - b1 * k + b2) * norm;
+            section.a1 = 2.0 * (a2 - k * k) * norm;
+            section.a2 = (k * k - a1 * k + a2) * norm;
+            return section;
+        };
+
+    const auto w1 = prewarp(pole1, sampleRate);
+    const auto w2 = prewarp(pole2, sampleRate);
+    const auto w3 = prewarp(pole3, sampleRate);
+    const auto w4 = prewarp(pole4, sampleRate);
+
+    // C: s^2 / (s + w1)^2 and 1 / (s + w4)^2. A adds s^2 / ((s + w2)(s + w3)).
+    highPass = bilinear(1.0, 0.0, 0.0, 2.0 * w1, w1 * w1);
+    lowPass = bilinear(0.0, 0.0, 1.0, 2.0 * w4, w4 * w4);
+    aSection = bilinear(1.0, 0.0, 0.0, w2 + w3, w2 * w3);
+
+    // Both weightings are 0 dB at 1 kHz by definition
+    const auto cGain = 1.0 / (getMagnitude(highPass, referenceFrequency, sampleRate) * getMagnitude(lowPass, referenceFrequency, sampleRate));
+    lowPass.b0 *= cGain;
+    lowPass.b1 *= cGain;
+    lowPass.b2 *= cGain;
+
+    const auto aGain = 1.0 / getMagnitude(aSection, referenceFrequency, sampleRate);
+    aSection.b0 *= aGain;
+    aSection.b1 *= aGain;
+    aSection.b2 *= aGain;
+
+    timeWeighting.prepare(sampleRate, numWeightings);
+
+    for (size_t p = 0; p < intervals.size(); ++p)
+        intervals[p].length = options.periods[p] > 0.0 ? juce::jmax(juce::int64(1), static_cast<juce::int64>(std::llround(options.periods[p] * sampleRate)))
+                                                       : 0;
+
+    reset();
+}
+
+void SoundLevelMeter::reset() noexcept
+{
+    for (auto* section : { &highPass, &lowPass, &aSection })
+        section->s1 = section->s2 = 0.0;
+
+    timeWeighting.reset();
+    resetSession();
+}
+
+void SoundLevelMeter::resetSession() noexcept
+{
+    timeWeighting.resetMaxima();
+    peaks.fill(0.0);
+
+    // Rolling intervals restart too, so every Leq of a recording is aligned to its start
+    for (auto& interval : intervals)
+    {
+        interval.fill = 0;
+        interval.sums.fill(0.0);
+        interval.completed.fill(0.0);
+        interval.hasCompleted = false;
+    }
+}
+
+//==============================================================================
+void SoundLevelMeter::process(const float* samples, int numSamples) noexcept
+{
+    int offset = 0;
+
+    while (offset < numSamples)
+    {
+        // Short runs that stop at the next interval boundary, so the accumulators only see whole runs
+        auto count = juce::jmin(numSamples - offset, runSize);
+
+        for (const auto& interval : intervals)
+            if (interval.length > 0)
+                count = static_cast<int>(juce::jmin(static_cast<juce::int64>(count), interval.length - interval.fill));
+
+        auto hp = highPass, lp = lowPass, aw = aSection;
+        auto peakA = peaks[0], peakC = peaks[1], peakZ = peaks[2];
+        double sumA = 0.0, sumC = 0.0, sumZ = 0.0;
+
+        for (int i = 0; i < count; ++i)
+        {
+            const auto z = static_cast<double>(samples[offset + i]);
+
+            const auto h = hp.b0 * z + hp.s1;
+            hp.s1 = hp.b1 * z - hp.a1 * h + hp.s2;
+            hp.s2 = hp.b2 * z - hp.a2 * h;
+
+            const auto c = lp.b0 * h + lp.s1;
+            lp.s1 = lp.b1 * h - lp.a1 * c + lp.s2;
+            lp.s2 = lp.b2 * h - lp.a2 * c;
+
+            const auto a = aw.b0 * c + aw.s1;
+            aw.s1 = aw.b1 * c - aw.a1 * a + aw.s2;
+            aw.s2 = aw.b2 * c - aw.a2 * a;
+
+            auto* square = squares.data() + i * numWeightings;
+            square[0] = a * a;
+            square[1] = c * c;
+            square[2] = z * z;
+
+            sumA += square[0];
+            sumC += square[1];
+            sumZ += square[2];
+
+            peakA = juce::jmax(peakA, std::abs(a));
+            peakC = juce::jmax(peakC, std::abs(c));
+            peakZ = juce::jmax(peakZ, std::abs(z));
+        }
+
+        highPass = hp;
+        lowPass = lp;
+        aSection = aw;
+        peaks = { peakA, peakC, peakZ };
+
+        timeWeighting.process(squares.data(), count);
+
+        for (auto& interval : intervals)
+        {
+            interval.sums[0] += sumA;
+            interval.sums[1] += sumC;
+            interval.sums[2] += sumZ;
+            interval.fill += count;
+
+            if (interval.fill == interval.length)
+            {
+                for (size_t w = 0; w < interval.sums.size(); ++w)
+                    interval.completed[w] = interval.sums[w] / static_cast<double>(interval.length);
+
+                interval.sums.fill(0.0);
+                interval.fill = 0;
+                interval.hasCompleted = true;
+            }
+        }
+
+        offset += count;
+    }
+}
+
+float SoundLevelMeter::getEquivalentLevel(Weighting weighting, int period) const noexcept
+{
+    if (!juce::isPositiveAndBelow(period, numPeriods))
+        return minimumLevel;
+
+    const auto& interval = intervals[(size_t)period];
+    const auto w = (size_t)weighting;
+
+    if (interval.hasCompleted)
+        return meanSquareToLevel(interval.completed[w]);
+
+    return interval.fill > 0 ? meanSquareToLevel(interval.sums[w] / static_cast<double>(interval.fill))
+                             : minimumLevel;
+}
+
+float SoundLevelMeter::getPeakLevel(Weighting weighting) const noexcept
+{
+    const auto peak = peaks[(size_t)weighting];
+    return meanSquareToLevel(peak * peak);
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "TimeWeighting.h"
+#include <array>
+
+//==============================================================================
+/**
+    Integrating-averaging sound level meter in the style of IEC 61672-1: A, C and Z
+    frequency weightings, equivalent continuous levels (Leq) over several periods at
+    once, Fast, Slow and Impulse time-weighted levels with their maxima, and sample peaks.
+
+    The weighting filters are the standard analogue poles (20.6, 107.7, 737.9 and
+    12194 Hz) moved to the sample rate with the prewarped bilinear transform, which stays
+    within the class 1 tolerances from 44.1 kHz up. They share
+    sections: C is a double high-pass at 20.6 Hz and a double low-pass at 12194 Hz, and A
+    is C followed by one more section for the 107.7 and 737.9 Hz poles, so all three
+    weightings cost three biquads per sample.
+
+    Each Leq is a double-precision sum of squares over its current interval. Samples are
+    filtered in runs that end at the next interval boundary and every accumulator only
+    sees the sums of whole runs, so an hour-long Leq costs the same per sample as a
+    one-second one. The weighted squares of each run also feed a TimeWeighting with one
+    channel per frequency weighting. Levels are in dB relative to a full-scale RMS of 1,
+    like the band levels. Nothing allocates after prepare().
+*/
+class SoundLevelMeter
+{
+public:
+    enum class Weighting
+    {
+        a,
+        c,
+        z
+    };
+
+    static constexpr int numWeightings = 3;
+    static constexpr int numPeriods = 4;
+    static constexpr float minimumLevel = -100.0f;
+
+    struct Options
+    {
+        // Leq integration periods in seconds; 0 integrates over the whole session
+        std::array<double, numPeriods> periods{ 1.0, 60.0, 900.0, 0.0 };
+    };
+
+    SoundLevelMeter() = default;
+
+    void prepare(double sampleRate, const Options& optionsToUse);
+    void prepare(double sampleRate) { prepare(sampleRate, Options()); }
+
+    /** Clears the filters, every Leq and the maxima. */
+    void reset() noexcept;
+
+    /**
+        Restarts every Leq interval, the maxima and the peaks, e.g. when a recording starts.
+        The filters keep their state, so the levels don't settle again.
+    */
+    void resetSession() noexcept;
+
+    /** Real-time safe. */
+    void process(const float* samples, int numSamples) noexcept;
+
+    /**
+        Leq of the last completed interval of a period, or of the interval in progress
+        until the first one completes. Session periods are always the interval in progress.
+    */
+    float getEquivalentLevel(Weighting weighting, int period) const noexcept;
+
+    /** Time-weighted mean square as of the last sample processed. */
+    double getTimeWeightedMeanSquare(Weighting weighting, TimeWeighting::Mode mode) const noexcept
+    {
+        return timeWeighting.getMeanSquare((int)weighting, mode);
+    }
+
+    /** The same in dB: LAF, LCS, LAI... */
+    float getTimeWeightedLevel(Weighting weighting, TimeWeighting::Mode mode) const noexcept
+    {
+        return meanSquareToLevel(getTimeWeightedMeanSquare(weighting, mode));
+    }
+
+    /** Highest time-weighted level since the session started (LAFmax, LASmax...). */
+    float getMaxTimeWeightedLevel(Weighting weighting, TimeWeighting::Mode mode) const noexcept
+    {
+        return meanSquareToLevel(timeWeighting.getMaxMeanSquare((int)weighting, mode));
+    }
+
+    /** Highest absolute weighted sample since the session started (LCpeak, LZpeak...). */
+    float getPeakLevel(Weighting weighting) const noexcept;
+
+    const Options& getOptions() const noexcept { return options; }
+
+    /** "1s", "1min", "15min", "Session"... for column names and labels. */
+    static juce::String getPeriodName(double seconds);
+
+    /** "LAeq_1s", "LAeq_1min"... one per period of the options for A, then C, then Z. */
+    static juce::StringArray getEquivalentLevelNames(const Options& options);
+
+private:
+    static constexpr int runSize = 256;
+
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+        double s1 = 0.0, s2 = 0.0;      // transposed direct form II
+    };
+
+    struct Interval
+    {
+        juce::int64 length = 0;         // samples; 0 for the session
+        juce::int64 fill = 0;
+        std::array<double, numWeightings> sums{};
+        std::array<double, numWeightings> completed{};
+        bool hasCompleted = false;
+    };
+
+    static float meanSquareToLevel(double meanSquare) noexcept;
+    static double getMagnitude(const Biquad& section, double frequency, double sampleRate) noexcept;
+
+    Options options;
+    double currentSampleRate = 44100.0;
+
+    Biquad highPass, lowPass, aSection;
+    std::array<double, numWeightings> peaks{};
+
+    TimeWeighting timeWeighting;
+    std::array<double, runSize * numWeightings> squares{};  // A, C, Z interleaved
+
+    std::array<Interval, numPeriods> intervals;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SoundLevelMeter)
+};
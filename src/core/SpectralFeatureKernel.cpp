@@ -0,0 +1,165 @@
+#include "SpectralFeatureKernel.h"
+
+namespace
+{
+    // Natural log accurate to ~2e-4, written without branches or library calls so
+    // that it vectorises along with the rest of the kernel.
+    inline float fastLog(float x) noexcept
+    {
+        juce::uint32 bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+
+        const auto exponent = static_cast<float>(static_cast<int>((bits >> 23) & 0xff) - 127);
+
+        bits = (bits & 0x007fffffu) | 0x3f800000u;
+        float mantissa;
+        std::memcpy(&mantissa, &bits, sizeof(mantissa));
+
+        // log2 of the mantissa in [1, 2), least-squares quartic
+        const auto log2Mantissa = (((-0.0791538f * mantissa + 0.6288414f) * mantissa - 2.0811285f) * mantissa
+                                   + 4.0284505f) * mantissa - 2.4968058f;
+
+        return 0.69314718f * (exponent + log2Mantissa);
+    }
+}
+
+//==============================================================================
+float SpectralFeatureKernel::calculateSquaredDeviation(const float* magnitudes, float centroid) const noexcept
+{
+    // Magnitude-weighted squared distance from the centroid, laned like the main pass
+    float sumMD2[numLanes] = {};
+    const auto numWholeBins = numBins / numLanes * numLanes;
+
+    for (int bin = 0; bin < numWholeBins; bin += numLanes)
+    {
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const auto deviation = binFrequencies[(size_t)(bin + lane)] - centroid;
+            sumMD2[lane] += magnitudes[bin + lane] * deviation * deviation;
+        }
+    }
+
+    for (int bin = numWholeBins; bin < numBins; ++bin)
+    {
+        const auto deviation = binFrequencies[(size_t)bin] - centroid;
+        sumMD2[0] += magnitudes[bin] * deviation * deviation;
+    }
+
+    float total = 0.0f;
+    for (int lane = 0; lane < numLanes; ++lane)
+        total += sumMD2[lane];
+
+    return total;
+}
+
+void SpectralFeatureKernel::prepare(double sampleRate, int fftSize, float crossoverHz, float newRolloffFraction)
+{
+    numBins = fftSize / 2;
+    rolloffFraction = newRolloffFraction;
+    logNumBins = std::log(static_cast<float>(numBins));
+
+    // Round the tables up to whole lane groups; padding bins have zero weight
+    const auto paddedSize = static_cast<size_t>((numBins + numLanes - 1) / numLanes * numLanes);
+
+    binFrequencies.assign(paddedSize, 0.0f);
+    highBandMask.assign(paddedSize, 0.0f);
+    groupMagnitudes.assign(paddedSize / numLanes, 0.0f);
+
+    const auto crossoverBin = static_cast<int>((crossoverHz * fftSize) / sampleRate);
+
+    for (int i = 0; i < numBins; ++i)
+    {
+        const auto frequency = static_cast<float>((i * sampleRate) / fftSize);
+
+        binFrequencies[(size_t)i] = frequency;
+        highBandMask[(size_t)i] = i < crossoverBin ? 0.0f : 1.0f;
+    }
+}
+
+SpectralFeatures SpectralFeatureKernel::process(const float* magnitudes) noexcept
+{
+    float sumM[numLanes] = {}, sumMF[numLanes] = {}, sumHigh[numLanes] = {};
+    float sumLogM[numLanes] = {}, sumMLogM[numLanes] = {};
+
+    const auto numWholeGroups = numBins / numLanes;
+
+    auto accumulateGroup = [&](const float* m, int bin, int count)
+        {
+            float groupSum[numLanes] = {};
+
+            for (int lane = 0; lane < count; ++lane)
+            {
+                const auto magnitude = m[lane];
+                const auto logMagnitude = fastLog(magnitude + 1.0e-12f);
+                const auto index = static_cast<size_t>(bin + lane);
+
+                groupSum[lane] = magnitude;
+                sumM[lane] += magnitude;
+                sumMF[lane] += magnitude * binFrequencies[index];
+                sumHigh[lane] += magnitude * highBandMask[index];
+                sumLogM[lane] += logMagnitude;
+                sumMLogM[lane] += magnitude * logMagnitude;
+            }
+
+            float total = 0.0f;
+            for (int lane = 0; lane < numLanes; ++lane)
+                total += groupSum[lane];
+
+            groupMagnitudes[(size_t)(bin / numLanes)] = total;
+        };
+
+    for (int group = 0; group < numWholeGroups; ++group)
+        accumulateGroup(magnitudes + group * numLanes, group * numLanes, numLanes);
+
+    if (const auto remainder = numBins - numWholeGroups * numLanes; remainder > 0)
+        accumulateGroup(magnitudes + numWholeGroups * numLanes, numWholeGroups * numLanes, remainder);
+
+    // Fold the lanes
+    float total = 0.0f, weightedFrequency = 0.0f, high = 0.0f;
+    float logSum = 0.0f, magnitudeLogSum = 0.0f;
+
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        total += sumM[lane];
+        weightedFrequency += sumMF[lane];
+        high += sumHigh[lane];
+        logSum += sumLogM[lane];
+        magnitudeLogSum += sumMLogM[lane];
+    }
+
+    SpectralFeatures features;
+    features.totalMagnitude = total;
+    features.highBandMagnitude = high;
+    features.lowBandMagnitude = total - high;
+
+    if (total <= 0.0f)
+        return features;
+
+    const auto centroid = weightedFrequency / total;
+    features.centroidHz = centroid;
+    features.spreadHz = std::sqrt(calculateSquaredDeviation(magnitudes, centroid) / total);
+
+    // Flatness: geometric mean over arithmetic mean
+    const auto arithmeticMean = total / static_cast<float>(numBins);
+    features.flatness = juce::jlimit(0.0f, 1.0f, std::exp(logSum / static_cast<float>(numBins)) / arithmeticMean);
+
+    // Entropy of the normalised spectrum p = m / total: H = log(total) - sum(m log m) / total
+    const auto entropy = std::log(total) - magnitudeLogSum / total;
+    features.entropy = juce::jlimit(0.0f, 1.0f, entropy / logNumBins);
+
+    // Rolloff: find the group holding the threshold, then the bin inside it
+    const auto threshold = rolloffFraction * total;
+    float cumulative = 0.0f;
+    int group = 0;
+
+    while (group < (int)groupMagnitudes.size() - 1 && cumulative + groupMagnitudes[(size_t)group] < threshold)
+        cumulative += groupMagnitudes[(size_t)group++];
+
+    int bin = group * numLanes;
+    while (bin < numBins - 1 && cumulative + magnitudes[bin] < threshold)
+        cumulative += magnitudes[bin++];
+
+    features.rolloffHz = binFrequencies[(size_t)bin];
+
+    return features;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <vector>
+
+//==============================================================================
+struct SpectralFeatures
+{
+    float centroidHz = 0.0f;
+    float spreadHz = 0.0f;
+    float rolloffHz = 0.0f;
+    float flatness = 0.0f;          // 0 (tonal) to 1 (white)
+    float entropy = 0.0f;           // normalised to 0-1
+    float lowBandMagnitude = 0.0f;  // below the crossover
+    float highBandMagnitude = 0.0f; // at and above the crossover
+    float totalMagnitude = 0.0f;
+};
+
+//==============================================================================
+/**
+    Computes every per-frame spectral feature in one pass over the magnitude spectrum,
+    except the spread, which takes a second pass around the centroid: E[f^2] - centroid^2
+    cancels to noise in float for narrow spectra high up.
+
+    Bin frequencies and the band mask are tabulated in prepare(), so the hot loop is
+    nothing but multiply-adds. Bins are processed in groups of numLanes with one
+    accumulator per lane, which lets the compiler keep each group in a SIMD register
+    without needing to reassociate the float sums.
+*/
+class SpectralFeatureKernel
+{
+public:
+    SpectralFeatureKernel() = default;
+
+    /** Builds the bin tables. Allocates, so call from prepareToPlay. */
+    void prepare(double sampleRate, int fftSize, float crossoverHz = 2000.0f, float rolloffFraction = 0.85f);
+
+    /** Analyses getNumBins() magnitudes. Real-time safe. */
+    SpectralFeatures process(const float* magnitudes) noexcept;
+
+    int getNumBins() const noexcept { return numBins; }
+    const float* getBinFrequencies() const noexcept { return binFrequencies.data(); }
+
+private:
+    static constexpr int numLanes = 8;
+
+    float calculateSquaredDeviation(const float* magnitudes, float centroid) const noexcept;
+
+    int numBins = 0;
+    float rolloffFraction = 0.85f;
+    float logNumBins = 1.0f;
+
+    std::vector<float> binFrequencies;
+    std::vector<float> highBandMask;    // 0 below the crossover, 1 above
+    std::vector<float> groupMagnitudes; // magnitude sum per group of numLanes bins, for the rolloff search
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectralFeatureKernel)
+};
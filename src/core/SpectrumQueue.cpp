@@ -0,0 +1,42 @@
+#include "SpectrumQueue.h"
+
+//==============================================================================
+SpectrumQueue::SpectrumQueue(int numBinsPerSpectrum, int capacityInSpectra)
+    : numBins(numBinsPerSpectrum),
+    fifo(capacityInSpectra),
+    storage((size_t)numBinsPerSpectrum * (size_t)capacityInSpectra, 0.0f)
+{
+}
+
+bool SpectrumQueue::push(const float* magnitudes) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 + size2 < 1)
+        return false;
+
+    const auto slot = size1 > 0 ? start1 : start2;
+    juce::FloatVectorOperations::copy(storage.data() + (size_t)slot * (size_t)numBins, magnitudes, numBins);
+    fifo.finishedWrite(1);
+    return true;
+}
+
+bool SpectrumQueue::pop(float* dest) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(1, start1, size1, start2, size2);
+
+    if (size1 + size2 < 1)
+        return false;
+
+    const auto slot = size1 > 0 ? start1 : start2;
+    juce::FloatVectorOperations::copy(dest, storage.data() + (size_t)slot * (size_t)numBins, numBins);
+    fifo.finishedRead(1);
+    return true;
+}
+
+void SpectrumQueue::discardAll() noexcept
+{
+    fifo.finishedRead(fifo.getNumReady());
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <vector>
+
+//==============================================================================
+/**
+    Lock-free single-producer/single-consumer queue of magnitude spectra, from the
+    analysis thread to the GUI.
+
+    Storage is allocated once in the constructor, so neither side ever allocates. When
+    the GUI falls behind, new spectra are dropped rather than blocking the analysis.
+*/
+class SpectrumQueue
+{
+public:
+    SpectrumQueue(int numBinsPerSpectrum, int capacityInSpectra);
+
+    int getNumBins() const noexcept { return numBins; }
+
+    /** Producer only. Returns false if the queue was full. */
+    bool push(const float* magnitudes) noexcept;
+
+    /** Consumer only. Copies the oldest spectrum into dest (getNumBins() values) and removes it. */
+    bool pop(float* dest) noexcept;
+
+    /** Consumer only. Discards everything queued, e.g. spectra that piled up while nobody was reading. */
+    void discardAll() noexcept;
+
+    int getNumReady() const noexcept { return fifo.getNumReady(); }
+
+private:
+    const int numBins;
+    juce::AbstractFifo fifo;
+    std::vector<float> storage;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumQueue)
+};
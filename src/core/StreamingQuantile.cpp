@@ -0,0 +1,111 @@
+#include "StreamingQuantile.h"
+#include <algorithm>
+
+//==============================================================================
+StreamingQuantile::StreamingQuantile(double probabilityToUse) noexcept
+{
+    setProbability(probabilityToUse);
+}
+
+void StreamingQuantile::setProbability(double newProbability) noexcept
+{
+    probability = juce::jlimit(0.0, 1.0, newProbability);
+    increments = { 0.0, probability / 2.0, probability, (1.0 + probability) / 2.0, 1.0 };
+    reset();
+}
+
+void StreamingQuantile::reset() noexcept
+{
+    heights.fill(0.0);
+    positions = { 1.0, 2.0, 3.0, 4.0, 5.0 };
+    desired = { 1.0, 1.0 + 2.0 * probability, 1.0 + 4.0 * probability, 3.0 + 2.0 * probability, 5.0 };
+    count = 0;
+}
+
+void StreamingQuantile::add(double value) noexcept
+{
+    // The first values are kept sorted, and become the markers once there are five
+    if (count < numMarkers)
+    {
+        auto* end = heights.data() + count;
+        auto* slot = std::upper_bound(heights.data(), end, value);
+        std::copy_backward(slot, end, end + 1);
+        *slot = value;
+        ++count;
+        return;
+    }
+
+    // Cell the value falls in, stretching the extremes if it lies outside them
+    int cell;
+
+    if (value < heights[0])
+    {
+        heights[0] = value;
+        cell = 0;
+    }
+    else if (value >= heights[numMarkers - 1])
+    {
+        heights[numMarkers - 1] = value;
+        cell = numMarkers - 2;
+    }
+    else
+    {
+        cell = 0;
+
+        while (value >= heights[(size_t)cell + 1])
+            ++cell;
+    }
+
+    for (int i = cell + 1; i < numMarkers; ++i)
+        positions[(size_t)i] += 1.0;
+
+    for (int i = 0; i < numMarkers; ++i)
+        desired[(size_t)i] += increments[(size_t)i];
+
+    // Move each inner marker that is a whole position or more from where it should be
+    for (size_t i = 1; i + 1 < numMarkers; ++i)
+    {
+        const auto offset = desired[i] - positions[i];
+
+        if ((offset >= 1.0 && positions[i + 1] - positions[i] > 1.0)
+            || (offset <= -1.0 && positions[i - 1] - positions[i] < -1.0))
+        {
+            const auto step = offset > 0.0 ? 1.0 : -1.0;
+
+            const auto parabolic = heights[i] + step / (positions[i + 1] - positions[i - 1])
+                                   * ((positions[i] - positions[i - 1] + step) * (heights[i + 1] - heights[i]) / (positions[i + 1] - positions[i])
+                                      + (positions[i + 1] - positions[i] - step) * (heights[i] - heights[i - 1]) / (positions[i] - positions[i - 1]));
+
+            if (heights[i - 1] < parabolic && parabolic < heights[i + 1])
+            {
+                heights[i] = parabolic;
+            }
+            else
+            {
+                // The parabola overshoots a neighbour; fall back to linear
+                const auto neighbour = step > 0.0 ? i + 1 : i - 1;
+                heights[i] += step * (heights[neighbour] - heights[i]) / (positions[neighbour] - positions[i]);
+            }
+
+            positions[i] += step;
+        }
+    }
+
+    ++count;
+}
+
+double StreamingQuantile::getQuantile() const noexcept
+{
+    if (count == 0)
+        return 0.0;
+
+    if (count >= numMarkers)
+        return heights[2];
+
+    // Exact, interpolated between the sorted values seen so far
+    const auto rank = probability * static_cast<double>(count - 1);
+    const auto below = static_cast<size_t>(rank);
+    const auto above = juce::jmin(below + 1, static_cast<size_t>(count - 1));
+
+    return heights[below] + (rank - static_cast<double>(below)) * (heights[above] - heights[below]);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+
+//==============================================================================
+/**
+    Running estimate of one quantile of a stream, with the P² algorithm of Jain and
+    Chlamtac (1985): five markers track the minimum, the quantile, the maximum and the
+    two points halfway between, and each value nudges the inner three along a piecewise
+    parabola through their neighbours. The first five values are kept exactly.
+
+    Memory and the cost per value are constant, however long the stream, and nothing
+    allocates, so it can be updated from the audio thread.
+*/
+class StreamingQuantile
+{
+public:
+    /** probability is the fraction of values below the quantile, e.g. 0.9 for the 90th percentile. */
+    explicit StreamingQuantile(double probability = 0.5) noexcept;
+
+    void setProbability(double newProbability) noexcept;
+    double getProbability() const noexcept { return probability; }
+
+    void reset() noexcept;
+
+    void add(double value) noexcept;
+
+    /** Current estimate; 0 before the first value. */
+    double getQuantile() const noexcept;
+
+    juce::int64 getCount() const noexcept { return count; }
+
+private:
+    static constexpr int numMarkers = 5;
+
+    double probability = 0.5;
+    std::array<double, numMarkers> heights{};       // marker values
+    std::array<double, numMarkers> positions{};     // actual positions, 1-based
+    std::array<double, numMarkers> desired{};       // desired positions
+    std::array<double, numMarkers> increments{};    // desired position increment per value
+    juce::int64 count = 0;
+};
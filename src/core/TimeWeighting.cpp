@@ -0,0 +1,63 @@
+#include "TimeWeighting.h"
+
+//==============================================================================
+void TimeWeighting::prepare(double sampleRate, int numChannelsToUse)
+{
+    numChannels = juce::jmax(1, numChannelsToUse);
+
+    const auto numLanes = (size_t)(numModes * numChannels);
+    rise.resize(numLanes);
+    decay.resize(numLanes);
+    state.resize(numLanes);
+    maxima.resize(numLanes);
+    input.resize(numLanes);
+
+    auto coefficient = [sampleRate](double timeConstant) { return 1.0 - std::exp(-1.0 / (timeConstant * sampleRate)); };
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        rise[getLane(ch, Mode::fast)] = decay[getLane(ch, Mode::fast)] = coefficient(fastTimeConstant);
+        rise[getLane(ch, Mode::slow)] = decay[getLane(ch, Mode::slow)] = coefficient(slowTimeConstant);
+        rise[getLane(ch, Mode::impulse)] = coefficient(impulseRiseTimeConstant);
+        decay[getLane(ch, Mode::impulse)] = coefficient(impulseDecayTimeConstant);
+    }
+
+    reset();
+}
+
+void TimeWeighting::reset() noexcept
+{
+    std::fill(state.begin(), state.end(), 0.0);
+    resetMaxima();
+}
+
+void TimeWeighting::resetMaxima() noexcept
+{
+    std::fill(maxima.begin(), maxima.end(), 0.0);
+}
+
+void TimeWeighting::process(const double* squares, int numSamples) noexcept
+{
+    const auto numLanes = state.size();
+    auto* s = state.data();
+    auto* m = maxima.data();
+    auto* x = input.data();
+    const auto* up = rise.data();
+    const auto* down = decay.data();
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        // Every time weighting of a channel sees the same input
+        const auto* frame = squares + (size_t)i * (size_t)numChannels;
+
+        for (int mode = 0; mode < numModes; ++mode)
+            std::copy(frame, frame + numChannels, x + mode * numChannels);
+
+        for (size_t lane = 0; lane < numLanes; ++lane)
+        {
+            const auto k = x[lane] > s[lane] ? up[lane] : down[lane];
+            s[lane] += k * (x[lane] - s[lane]);
+            m[lane] = juce::jmax(m[lane], s[lane]);
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <vector>
+
+//==============================================================================
+/**
+    IEC 61672-1 exponential time weighting of squared signals: Fast (125 ms), Slow (1 s)
+    and Impulse (35 ms rise, 1.5 s decay), each with a running maximum.
+
+    Every channel gets one integrator per time weighting. They all live in flat lane
+    arrays with a rise and a decay coefficient each (equal for Fast and Slow), so one
+    sample updates every lane in a single branch-free loop that the compiler vectorises
+    across channels. The integrators run per sample, so levels don't depend on how the
+    signal was split into blocks. Nothing allocates after prepare().
+*/
+class TimeWeighting
+{
+public:
+    enum class Mode
+    {
+        fast,
+        slow,
+        impulse
+    };
+
+    static constexpr int numModes = 3;
+
+    TimeWeighting() = default;
+
+    void prepare(double sampleRate, int numChannels);
+
+    /** Clears the integrators and the maxima. */
+    void reset() noexcept;
+
+    /** Restarts the maxima only. */
+    void resetMaxima() noexcept;
+
+    /**
+        Feeds numSamples frames of squared signal, interleaved: frame i holds
+        numChannels values starting at squares[i * numChannels]. Real-time safe.
+    */
+    void process(const double* squares, int numSamples) noexcept;
+
+    /** Time-weighted mean square, as of the last sample processed. */
+    double getMeanSquare(int channel, Mode mode) const noexcept { return state[getLane(channel, mode)]; }
+
+    /** Highest time-weighted mean square since the last reset of the maxima. */
+    double getMaxMeanSquare(int channel, Mode mode) const noexcept { return maxima[getLane(channel, mode)]; }
+
+    int getNumChannels() const noexcept { return numChannels; }
+
+private:
+    static constexpr double fastTimeConstant = 0.125;
+    static constexpr double slowTimeConstant = 1.0;
+    static constexpr double impulseRiseTimeConstant = 0.035;
+    static constexpr double impulseDecayTimeConstant = 1.5;
+
+    size_t getLane(int channel, Mode mode) const noexcept { return (size_t)((int)mode * numChannels + channel); }
+
+    int numChannels = 0;
+
+    // One lane per time weighting and channel, time weighting major
+    std::vector<double> rise, decay;
+    std::vector<double> state, maxima;
+    std::vector<double> input;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TimeWeighting)
+};
@@ -0,0 +1,293 @@
+#include "TonalityAnalyzer.h"
+#include <algorithm>
+
+namespace
+{
+    constexpr float lowestFrequency = 20.0f;   // ECMA-418-1 truncates the lower band here
+    constexpr float maxRatio = 60.0f;          // dB, caps both ratios when a band holds no power
+
+    /** Lower edge of the critical band centred geometrically on a frequency. */
+    float getLowerEdge(float centre) noexcept
+    {
+        const auto bandwidth = TonalityAnalyzer::getCriticalBandwidth(centre);
+        return 0.5f * (std::sqrt(bandwidth * bandwidth + 4.0f * centre * centre) - bandwidth);
+    }
+
+    float getUpperEdge(float centre) noexcept
+    {
+        return getLowerEdge(centre) + TonalityAnalyzer::getCriticalBandwidth(centre);
+    }
+
+    /** Centre of the band whose edge, as given by getEdge, lands on a frequency. Both edges rise with the centre. */
+    template <typename EdgeFunction>
+    float findCentre(float edge, float low, float high, EdgeFunction&& getEdge) noexcept
+    {
+        for (int i = 0; i < 40; ++i)
+        {
+            const auto mid = 0.5f * (low + high);
+            (getEdge(mid) < edge ? low : high) = mid;
+        }
+
+        return 0.5f * (low + high);
+    }
+
+    float powerRatioToDecibels(double numerator, double denominator) noexcept
+    {
+        if (numerator <= 0.0)
+            return -maxRatio;
+
+        return static_cast<float>(juce::jmin(static_cast<double>(maxRatio), 10.0 * std::log10(numerator / juce::jmax(denominator, 1.0e-30))));
+    }
+}
+
+//==============================================================================
+float TonalityAnalyzer::getCriticalBandwidth(float frequency) noexcept
+{
+    const auto kHz = frequency / 1000.0f;
+    return 25.0f + 75.0f * std::pow(1.0f + 1.4f * kHz * kHz, 0.69f);
+}
+
+void TonalityAnalyzer::prepare(double sampleRate, int fftSize, const Options& optionsToUse)
+{
+    options = optionsToUse;
+    numBins = fftSize / 2;
+    binWidth = static_cast<float>(sampleRate / fftSize);
+
+    const auto nyquist = static_cast<float>(sampleRate * 0.5);
+
+    auto toBin = [this](float frequency)
+        {
+            return juce::jlimit(0, numBins, juce::roundToInt(frequency / binWidth));
+        };
+
+    // Room for the main lobe and a noise bin either side, and at least one bin in each neighbouring band
+    firstBin = juce::jmax(mainLobeHalfWidth + 2, static_cast<int>(std::ceil(options.minFrequency / binWidth)));
+    lastBin = juce::jmin(numBins - mainLobeHalfWidth - 3, static_cast<int>(std::floor(options.maxFrequency / binWidth)));
+
+    const auto lowestBin = static_cast<int>(std::ceil(lowestFrequency / binWidth));
+
+    binBands.assign((size_t)numBins, {});
+
+    for (int k = firstBin; k <= lastBin; ++k)
+    {
+        const auto centre = static_cast<float>(k) * binWidth;
+        const auto bandwidth = getCriticalBandwidth(centre);
+        const auto lowerEdge = getLowerEdge(centre);
+        const auto upperEdge = lowerEdge + bandwidth;
+
+        // Neighbouring bands: the one whose upper edge is our lower edge, and the one whose lower edge is our upper edge
+        const auto lowerCentre = findCentre(lowerEdge, 0.0f, lowerEdge, getUpperEdge);
+        const auto lowerBandEdge = getLowerEdge(lowerCentre);
+        const auto upperCentre = findCentre(upperEdge, upperEdge, 4.0f * upperEdge, getLowerEdge);
+        const auto upperBandEdge = juce::jmin(nyquist, getUpperEdge(upperCentre));
+
+        auto& bands = binBands[(size_t)k];
+        bands.middleStart = juce::jmin(k - mainLobeHalfWidth - 1, toBin(lowerEdge));
+        bands.middleEnd = juce::jlimit(k + mainLobeHalfWidth + 2, numBins - 1, toBin(upperEdge));
+        bands.lowerStart = juce::jmax(0, juce::jmin(bands.middleStart - 1, juce::jmax(lowestBin, toBin(lowerBandEdge))));
+        bands.upperEnd = juce::jlimit(bands.middleEnd + 1, numBins, toBin(upperBandEdge));
+
+        // Every sum is brought to the nominal width of its band, so rounding to bins doesn't bias the ratios
+        const auto numNoiseBins = bands.middleEnd - bands.middleStart - mainLobeWidth;
+        bands.noiseScale = bandwidth / (static_cast<float>(numNoiseBins) * binWidth);
+        bands.lowerScale = (lowerEdge - lowerBandEdge) / (static_cast<float>(bands.middleStart - bands.lowerStart) * binWidth);
+        bands.upperScale = juce::jmax(0.0f, upperBandEdge - upperEdge) / (static_cast<float>(bands.upperEnd - bands.middleEnd) * binWidth);
+
+        // ECMA-418-1 prominence criteria: constant from 1 kHz up, rising towards low frequencies
+        const auto lowFrequencyTerm = std::log10(1000.0f / juce::jmin(1000.0f, centre));
+        bands.tnrCriterion = 8.0f + 8.33f * lowFrequencyTerm;
+        bands.prCriterion = 9.0f + 10.0f * lowFrequencyTerm;
+    }
+
+    power.assign((size_t)numBins, 0.0f);
+    bandMaxima.assign((size_t)numBins, 0);
+    cumulativePower.assign((size_t)numBins + 1, 0.0);
+
+    reset();
+}
+
+void TonalityAnalyzer::reset() noexcept
+{
+    numTracks = 0;
+    numPersistentTones = 0;
+    mostProminent = -1;
+    nextId = 1;
+}
+
+//==============================================================================
+void TonalityAnalyzer::process(const float* magnitudes) noexcept
+{
+    double sum = 0.0;
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        power[(size_t)k] = magnitudes[k] * magnitudes[k];
+        sum += power[(size_t)k];
+        cumulativePower[(size_t)k + 1] = sum;
+    }
+
+    int numCandidates = 0;
+    bool isSorted = true;
+
+    // Bins of decreasing power over the middle band of the current bin. Both band edges
+    // only move up with the bin, so its front is the band maximum at O(1) amortised.
+    int queueHead = 0, queueTail = 0, nextQueued = 0;
+
+    for (int k = firstBin; k <= lastBin; ++k)
+    {
+        const auto& bands = binBands[(size_t)k];
+
+        for (; nextQueued < bands.middleEnd; ++nextQueued)
+        {
+            while (queueTail > queueHead && power[(size_t)bandMaxima[(size_t)queueTail - 1]] <= power[(size_t)nextQueued])
+                --queueTail;
+
+            bandMaxima[(size_t)queueTail++] = nextQueued;
+        }
+
+        while (bandMaxima[(size_t)queueHead] < bands.middleStart)
+            ++queueHead;
+
+        // Only the highest bin of its own critical band: a weaker peak beside a tone would
+        // otherwise borrow the tone's prominence ratio
+        if (bandMaxima[(size_t)queueHead] != k)
+            continue;
+
+        TonalComponent tone;
+
+        if (!evaluate(k, tone))
+            continue;
+
+        tone.frequency = static_cast<float>(k) * binWidth;
+
+        // Parabolic interpolation of the log magnitude
+        const auto a = std::log(juce::jmax(magnitudes[k - 1], 1.0e-20f));
+        const auto b = std::log(juce::jmax(magnitudes[k], 1.0e-20f));
+        const auto c = std::log(juce::jmax(magnitudes[k + 1], 1.0e-20f));
+        const auto curvature = a - 2.0f * b + c;
+
+        if (curvature < 0.0f)
+            tone.frequency += juce::jlimit(-0.5f, 0.5f, 0.5f * (a - c) / curvature) * binWidth;
+
+        // With the list full, a tone only gets in by displacing the least prominent one
+        auto slot = numCandidates;
+
+        if (numCandidates == maxTones)
+        {
+            slot = 0;
+
+            for (int i = 1; i < maxTones; ++i)
+                if (candidates[(size_t)i].prominence < candidates[(size_t)slot].prominence)
+                    slot = i;
+
+            if (candidates[(size_t)slot].prominence >= tone.prominence)
+                continue;
+
+            isSorted = false;
+        }
+        else
+        {
+            ++numCandidates;
+        }
+
+        candidates[(size_t)slot] = tone;
+    }
+
+    if (!isSorted)
+        std::sort(candidates.begin(), candidates.begin() + numCandidates,
+                  [](const TonalComponent& x, const TonalComponent& y) { return x.frequency < y.frequency; });
+
+    updateTracks(numCandidates);
+}
+
+bool TonalityAnalyzer::evaluate(int bin, TonalComponent& tone) const noexcept
+{
+    const auto& bands = binBands[(size_t)bin];
+
+    auto sum = [this](int start, int end)
+        {
+            return cumulativePower[(size_t)end] - cumulativePower[(size_t)start];
+        };
+
+    const auto tonePower = sum(bin - mainLobeHalfWidth, bin + mainLobeHalfWidth + 1);
+
+    if (tonePower <= 0.0)
+        return false;
+
+    const auto middlePower = sum(bands.middleStart, bands.middleEnd);
+    const auto noisePower = juce::jmax(0.0, middlePower - tonePower) * bands.noiseScale;
+    const auto lowerPower = sum(bands.lowerStart, bands.middleStart) * bands.lowerScale;
+    const auto upperPower = sum(bands.middleEnd, bands.upperEnd) * bands.upperScale;
+
+    // Above the last full upper band (near Nyquist) the lower band stands in for both
+    const auto neighbourPower = bands.upperScale > 0.0f ? 0.5 * (lowerPower + upperPower) : lowerPower;
+
+    tone.toneToNoiseRatio = powerRatioToDecibels(tonePower, noisePower);
+    // Only the TNR's noise is scaled to the critical bandwidth; the PR takes the middle band as it is
+    tone.prominenceRatio = powerRatioToDecibels(middlePower, neighbourPower);
+    tone.prominence = juce::jmax(tone.toneToNoiseRatio - bands.tnrCriterion, tone.prominenceRatio - bands.prCriterion);
+
+    return tone.prominence >= 0.0f;
+}
+
+void TonalityAnalyzer::updateTracks(int numCandidates) noexcept
+{
+    // Both lists ascend in frequency, so matching is a single merge
+    const auto tolerance = static_cast<float>(mainLobeHalfWidth) * binWidth;
+    int track = 0, written = 0;
+
+    // A track nothing matched lives on for a few frames, as long as it doesn't crowd out a tone of this frame
+    auto keepMissed = [this, &written](const TonalComponent& missed, int candidatesLeft)
+        {
+            if (missed.numMissedFrames < options.maxMissedFrames && written + candidatesLeft < maxTones)
+            {
+                auto& kept = nextTracks[(size_t)written++];
+                kept = missed;
+                ++kept.numMissedFrames;
+            }
+        };
+
+    for (int c = 0; c < numCandidates; ++c)
+    {
+        auto tone = candidates[(size_t)c];
+
+        while (track < numTracks && tracks[(size_t)track].frequency < tone.frequency - tolerance)
+            keepMissed(tracks[(size_t)track++], numCandidates - c);
+
+        if (track < numTracks && tracks[(size_t)track].frequency <= tone.frequency + tolerance)
+        {
+            tone.id = tracks[(size_t)track].id;
+            tone.numFrames = tracks[(size_t)track].numFrames + 1;
+            ++track;
+        }
+        else
+        {
+            tone.id = nextId++;
+            tone.numFrames = 1;
+        }
+
+        tone.numMissedFrames = 0;
+        nextTracks[(size_t)written++] = tone;
+    }
+
+    while (track < numTracks)
+        keepMissed(tracks[(size_t)track++], 0);
+
+    std::copy(nextTracks.begin(), nextTracks.begin() + written, tracks.begin());
+    numTracks = written;
+    numPersistentTones = 0;
+    mostProminent = -1;
+
+    for (int i = 0; i < numTracks; ++i)
+    {
+        const auto& tone = tracks[(size_t)i];
+
+        if (tone.numMissedFrames > 0 || tone.numFrames < options.minFrames)
+            continue;
+
+        ++numPersistentTones;
+
+        if (mostProminent < 0 || tone.prominence > tracks[(size_t)mostProminent].prominence)
+            mostProminent = i;
+    }
+}
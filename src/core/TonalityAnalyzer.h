@@ -0,0 +1,123 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <vector>
+
+//==============================================================================
+/** A tone found in the magnitude spectrum and followed from frame to frame. */
+struct TonalComponent
+{
+    juce::uint32 id = 0;              // stays the same for as long as the tone is tracked
+    float frequency = 0.0f;           // Hz, interpolated between bins
+    float toneToNoiseRatio = 0.0f;    // dB, ECMA-418-1
+    float prominenceRatio = 0.0f;     // dB, ECMA-418-1
+    float prominence = 0.0f;          // dB above the nearer of the two ECMA-418-1 criteria
+    int numFrames = 0;                // frames the tone has been detected in
+    int numMissedFrames = 0;          // consecutive frames since it was last detected
+};
+
+//==============================================================================
+/**
+    Tonal components of an STFT magnitude spectrum, with the ECMA-418-1 tone-to-noise
+    ratio and prominence ratio of each, tracked across frames.
+
+    Every bin between 89.1 Hz and 11.2 kHz that is the highest of the critical band around
+    it is a candidate, found with a sliding maximum as the band moves up the spectrum.
+    The critical band around each bin, and the two bands adjacent to it, are worked out
+    once in prepare(), so with a prefix sum of the power spectrum both ratios cost a few
+    lookups per candidate and a frame is linear in the number of bins:
+
+    - TNR: the power of the peak's main lobe over the rest of its critical band, the
+      latter scaled up to the full critical bandwidth.
+    - PR: the power of the critical band centred on the peak over the mean of the
+      critical bands just below and above it.
+
+    A candidate is a tone when either ratio reaches the ECMA-418-1 criterion for its
+    frequency. Tones are matched to the tracks of the previous frame by frequency, in one
+    merge of two sorted lists; a track survives maxMissedFrames frames without a match
+    and counts as persistent once it has been seen in minFrames frames.
+
+    The main lobe is the peak bin and two on either side, the width of the Hann window of
+    the STFTProcessor. At a 2048-point FFT a critical band below 500 Hz is only four or five
+    bins wide, so there the band is widened to leave at least one noise bin each side of
+    the lobe, and leakage of the window limits the TNR of a pure tone to roughly 30 dB.
+    Nothing allocates after prepare().
+*/
+class TonalityAnalyzer
+{
+public:
+    struct Options
+    {
+        float minFrequency = 89.1f;     // Hz, the range of ECMA-418-1
+        float maxFrequency = 11220.0f;
+        int minFrames = 4;              // frames before a track counts as persistent, 100 ms at 40 frames/s
+        int maxMissedFrames = 2;        // frames a track is kept without a match
+    };
+
+    static constexpr int maxTones = 32;
+
+    TonalityAnalyzer() = default;
+
+    /** Builds the band tables. Allocates, so call from prepareToPlay. */
+    void prepare(double sampleRate, int fftSize, const Options& optionsToUse);
+    void prepare(double sampleRate, int fftSize) { prepare(sampleRate, fftSize, Options()); }
+
+    /** Forgets every track. */
+    void reset() noexcept;
+
+    /** Finds the tones of one frame of fftSize / 2 magnitudes and updates the tracks. Real-time safe. */
+    void process(const float* magnitudes) noexcept;
+
+    /** Tracks after the latest frame, in ascending frequency, including ones missed in it. */
+    int getNumTracks() const noexcept { return numTracks; }
+    const TonalComponent& getTrack(int index) const noexcept { return tracks[(size_t)index]; }
+
+    /** Persistent tones detected in the latest frame. */
+    int getNumPersistentTones() const noexcept { return numPersistentTones; }
+
+    /** The persistent tone of the latest frame furthest above its criterion, or nullptr. */
+    const TonalComponent* getMostProminentTone() const noexcept { return mostProminent >= 0 ? &tracks[(size_t)mostProminent] : nullptr; }
+
+    const Options& getOptions() const noexcept { return options; }
+
+    /** Critical bandwidth around a frequency, Hz, as ECMA-418-1 defines it. */
+    static float getCriticalBandwidth(float frequency) noexcept;
+
+private:
+    static constexpr int mainLobeHalfWidth = 2;   // bins, Hann window
+    static constexpr int mainLobeWidth = 2 * mainLobeHalfWidth + 1;
+
+    /** Critical bands around one bin: lower [lowerStart, middleStart), middle [middleStart, middleEnd), upper [middleEnd, upperEnd). */
+    struct BinBands
+    {
+        int lowerStart = 0, middleStart = 0, middleEnd = 0, upperEnd = 0;
+        float noiseScale = 0.0f;        // noise bins of the middle band -> critical bandwidth
+        float lowerScale = 0.0f;        // lower band bins -> its critical bandwidth
+        float upperScale = 0.0f;        // upper band bins -> its critical bandwidth
+        float tnrCriterion = 0.0f;      // dB
+        float prCriterion = 0.0f;       // dB
+    };
+
+    bool evaluate(int bin, TonalComponent& tone) const noexcept;
+    void updateTracks(int numCandidates) noexcept;
+
+    Options options;
+    int numBins = 0;
+    int firstBin = 0, lastBin = 0;
+    float binWidth = 0.0f;
+
+    std::vector<BinBands> binBands;
+    std::vector<float> power;
+    std::vector<double> cumulativePower;   // cumulativePower[k] = sum of power[0..k), numBins + 1 long
+    std::vector<int> bandMaxima;           // monotonic queue of bins for the band maximum
+
+    std::array<TonalComponent, maxTones> candidates;
+    std::array<TonalComponent, maxTones> tracks, nextTracks;
+    int numTracks = 0;
+    int numPersistentTones = 0;
+    int mostProminent = -1;
+    juce::uint32 nextId = 1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TonalityAnalyzer)
+};
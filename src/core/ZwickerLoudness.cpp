@@ -0,0 +1,386 @@
+#include "ZwickerLoudness.h"
+#include <iterator>
+
+namespace
+{
+    // ISO 532-1 tables, per critical band unless noted
+
+    // Threshold in quiet as a critical band level, without the transmission of the ear
+    constexpr float thresholdLevels[ZwickerLoudness::numCriticalBands] = {
+        30.0f, 18.0f, 12.0f, 8.0f, 7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 3.0f, 3.0f, 3.0f, 3.0f, 3.0f, 3.0f, 3.0f, 3.0f, 3.0f, 3.0f, 3.0f
+    };
+
+    // Transmission through the outer and middle ear
+    constexpr float earTransmission[ZwickerLoudness::numCriticalBands] = {
+        0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, -0.5f, -1.6f, -3.2f, -5.4f, -5.6f, -4.0f, -1.5f, 2.0f, 5.0f, 12.0f
+    };
+
+    // Level difference between diffuse and free field
+    constexpr float diffuseFieldCorrection[ZwickerLoudness::numCriticalBands] = {
+        0.0f, 0.0f, 0.5f, 0.9f, 1.2f, 1.6f, 2.3f, 2.8f, 3.0f, 2.0f, 0.0f, -1.4f, -2.0f, -1.9f, -1.0f, 0.5f, 3.0f, 4.0f, 4.3f, 4.0f
+    };
+
+    // Third-octave level to critical band level
+    constexpr float criticalBandAdaptation[ZwickerLoudness::numCriticalBands] = {
+        -0.25f, -0.6f, -0.8f, -0.8f, -0.5f, 0.0f, 0.5f, 1.1f, 1.5f, 1.7f, 1.8f, 1.8f, 1.7f, 1.6f, 1.4f, 1.2f, 0.8f, 0.5f, 0.0f, -0.5f
+    };
+
+    // Upper edges of the approximated critical bands in Bark; the last closes the pattern at 24 Bark
+    constexpr float upperEdges[ZwickerLoudness::numCriticalBands + 1] = {
+        0.9f, 1.8f, 2.8f, 3.5f, 4.4f, 5.4f, 6.6f, 7.9f, 9.2f, 10.6f, 12.3f, 13.8f, 15.2f, 16.7f, 18.1f, 19.3f, 20.6f, 21.8f, 22.7f, 23.6f, 24.0f
+    };
+
+    // Specific loudness ranges, sone per Bark, over which the upper slopes are taken as straight
+    constexpr float slopeRanges[] = {
+        21.5f, 18.0f, 15.1f, 11.5f, 9.0f, 6.1f, 4.4f, 3.1f, 2.13f, 1.36f, 0.82f, 0.42f, 0.30f, 0.22f, 0.15f, 0.10f, 0.035f, 0.0f
+    };
+
+    // Steepness of the upper slopes in sone per Bark (USL), one row per range above and one
+    // column per critical band, the last column covering every band from the eighth up
+    constexpr float upperSlopes[][8] = {
+        { 13.00f,  8.20f,  5.70f,  5.00f,  5.00f,  5.00f,  5.00f,  5.00f },
+        {  9.00f,  7.50f,  6.00f,  5.10f,  4.50f,  4.50f,  4.50f,  4.50f },
+        {  7.80f,  6.70f,  5.60f,  4.90f,  4.40f,  3.90f,  3.90f,  3.90f },
+        {  6.50f,  6.00f,  5.10f,  4.50f,  3.90f,  3.20f,  3.20f,  3.20f },
+        {  5.60f,  5.00f,  4.50f,  4.00f,  3.40f,  2.80f,  2.70f,  2.70f },
+        {  4.20f,  4.10f,  3.60f,  3.20f,  2.70f,  2.20f,  2.20f,  2.20f },
+        {  3.30f,  3.20f,  3.00f,  2.70f,  2.20f,  1.80f,  1.70f,  1.70f },
+        {  2.50f,  2.50f,  2.40f,  2.10f,  1.80f,  1.40f,  1.30f,  1.30f },
+        {  1.70f,  1.70f,  1.60f,  1.50f,  1.20f,  1.00f,  0.91f,  0.90f },
+        {  1.35f,  1.35f,  1.30f,  1.20f,  1.00f,  0.87f,  0.74f,  0.70f },
+        {  0.95f,  0.95f,  0.90f,  0.85f,  0.70f,  0.62f,  0.55f,  0.52f },
+        {  0.56f,  0.56f,  0.54f,  0.51f,  0.44f,  0.38f,  0.34f,  0.31f },
+        {  0.33f,  0.33f,  0.32f,  0.31f,  0.27f,  0.24f,  0.21f,  0.19f },
+        {  0.23f,  0.23f,  0.22f,  0.21f,  0.19f,  0.17f,  0.15f,  0.14f },
+        {  0.16f,  0.16f,  0.15f,  0.14f,  0.13f,  0.12f,  0.11f,  0.10f },
+        {  0.11f,  0.11f,  0.11f,  0.10f,  0.09f,  0.08f,  0.07f,  0.07f },
+        {  0.06f,  0.06f,  0.06f,  0.06f,  0.05f,  0.05f,  0.05f,  0.04f },
+        {  0.02f,  0.02f,  0.02f,  0.02f,  0.02f,  0.02f,  0.02f,  0.02f }
+    };
+
+    // Equal-loudness corrections of the third-octaves up to 250 Hz, for the level ranges below
+    constexpr int numCorrectionRanges = 8;
+
+    constexpr float correctionRanges[numCorrectionRanges] = { 45.0f, 55.0f, 65.0f, 71.0f, 80.0f, 90.0f, 100.0f, 120.0f };
+
+    constexpr float lowFrequencyCorrections[numCorrectionRanges][11] = {
+        { -32.0f, -24.0f, -16.0f, -10.0f, -5.0f, 0.0f, -7.0f, -3.0f, 0.0f, -2.0f, 0.0f },
+        { -29.0f, -22.0f, -15.0f, -10.0f, -4.0f, 0.0f, -7.0f, -2.0f, 0.0f, -2.0f, 0.0f },
+        { -27.0f, -19.0f, -14.0f,  -9.0f, -4.0f, 0.0f, -6.0f, -2.0f, 0.0f, -2.0f, 0.0f },
+        { -25.0f, -17.0f, -12.0f,  -9.0f, -3.0f, 0.0f, -5.0f, -2.0f, 0.0f, -2.0f, 0.0f },
+        { -23.0f, -16.0f, -11.0f,  -7.0f, -3.0f, 0.0f, -4.0f, -1.0f, 0.0f, -1.0f, 0.0f },
+        { -20.0f, -14.0f, -10.0f,  -6.0f, -3.0f, 0.0f, -4.0f, -1.0f, 0.0f, -1.0f, 0.0f },
+        { -18.0f, -12.0f,  -9.0f,  -6.0f, -2.0f, 0.0f, -3.0f, -1.0f, 0.0f, -1.0f, 0.0f },
+        { -15.0f, -10.0f,  -8.0f,  -4.0f, -2.0f, 0.0f, -3.0f, -1.0f, 0.0f, -1.0f, 0.0f }
+    };
+
+    // Nonlinear temporal decay and temporal weighting time constants, seconds
+    constexpr double decayShortTime = 0.005;
+    constexpr double decayLongTime = 0.015;
+    constexpr double decayVariableTime = 0.075;
+    constexpr double fastWeightingTime = 0.0035;
+    constexpr double slowWeightingTime = 0.07;
+    constexpr float fastWeightingShare = 0.47f;
+
+    constexpr float coreLoudnessExponent = 0.25f;
+    constexpr float coreLoudnessSlope = 0.25f;      // s in (1 - s + s * 10^((L - LTQ) / 10))^0.25 - 1
+}
+
+//==============================================================================
+float ZwickerLoudness::loudnessToLevel(float sones) noexcept
+{
+    if (sones >= 1.0f)
+        return 40.0f + 10.0f * std::log2(sones);
+
+    return juce::jmax(3.0f, 40.0f * std::pow(juce::jmax(0.0f, sones) + 0.0005f, 0.35f));
+}
+
+float ZwickerLoudness::levelToLoudness(float phons) noexcept
+{
+    if (phons >= 40.0f)
+        return std::exp2((phons - 40.0f) * 0.1f);
+
+    return juce::jmax(0.0f, std::pow(juce::jmax(0.0f, phons) / 40.0f, 1.0f / 0.35f) - 0.0005f);
+}
+
+//==============================================================================
+void ZwickerLoudness::prepare(const OctaveBandAnalyzer& bandsToUse, const Options& optionsToUse)
+{
+    options = optionsToUse;
+    const auto stepTime = 1.0 / bandsToUse.getPowerStepRate();
+
+    // Band smoothing time constant: two thirds of a period, fixed above 1 kHz
+    for (int i = 0; i < numBands; ++i)
+    {
+        const auto centre = juce::jmin(1000.0, OctaveBandAnalyzer::getThirdOctaveFrequency(firstBand + i));
+        smoothing[(size_t)i] = static_cast<float>(std::exp(-stepTime / (2.0 / (3.0 * centre))));
+    }
+
+    for (int i = 0; i < numCriticalBands; ++i)
+    {
+        levelOffset[(size_t)i] = -earTransmission[i] - criticalBandAdaptation[i]
+                               + (options.soundField == SoundField::diffuse ? diffuseFieldCorrection[i] : 0.0f);
+        threshold[(size_t)i] = thresholdLevels[i];
+        thresholdGain[(size_t)i] = 0.0635f * std::pow(10.0f, 0.025f * thresholdLevels[i]);
+    }
+
+    static_assert(std::size(slopeRanges) == numSlopeRanges, "one slope per range");
+    static_assert(std::size(upperSlopes) == numSlopeRanges && std::size(upperSlopes[0]) == numSlopeGroups, "one slope per range and band group");
+
+    // Two-pole decay while the output is above its slow state, solved exactly for one step
+    const auto p = (decayVariableTime + decayLongTime) / (decayVariableTime * decayShortTime);
+    const auto q = 1.0 / (decayShortTime * decayVariableTime);
+    const auto lambda1 = -p / 2.0 + std::sqrt(p * p / 4.0 - q);
+    const auto lambda2 = -p / 2.0 - std::sqrt(p * p / 4.0 - q);
+    const auto denominator = decayVariableTime * (lambda1 - lambda2);
+    const auto e1 = std::exp(lambda1 * stepTime);
+    const auto e2 = std::exp(lambda2 * stepTime);
+
+    decayB0 = static_cast<float>((e1 - e2) / denominator);
+    decayB1 = static_cast<float>(((decayVariableTime * lambda2 + 1.0) * e1 - (decayVariableTime * lambda1 + 1.0) * e2) / denominator);
+    decayB2 = static_cast<float>(((decayVariableTime * lambda1 + 1.0) * e1 - (decayVariableTime * lambda2 + 1.0) * e2) / denominator);
+    decayB3 = static_cast<float>((decayVariableTime * lambda1 + 1.0) * (decayVariableTime * lambda2 + 1.0) * (e1 - e2) / denominator);
+    decayLong = static_cast<float>(std::exp(-stepTime / decayLongTime));
+    decayShort = static_cast<float>(std::exp(-stepTime / decayShortTime));
+
+    fastWeighting = static_cast<float>(std::exp(-stepTime / fastWeightingTime));
+    slowWeighting = static_cast<float>(std::exp(-stepTime / slowWeightingTime));
+
+    reset();
+    numPowerStepsRead = bandsToUse.getNumPowerSteps();
+}
+
+void ZwickerLoudness::reset() noexcept
+{
+    for (auto& stage : smoothed)
+        stage.fill(0.0f);
+
+    decayOutput.fill(0.0f);
+    decayState.fill(0.0f);
+    coreLoudness.fill(0.0f);
+    specificLoudness.fill(0.0f);
+    instantaneousLoudness = 0.0f;
+    fastLoudness = slowLoudness = loudness = 0.0f;
+    numPowerStepsRead = 0;
+
+    resetStatistics();
+}
+
+void ZwickerLoudness::resetStatistics() noexcept
+{
+    histogram.fill(0);
+    numSteps = 0;
+    maxLoudness = 0.0f;
+}
+
+void ZwickerLoudness::process(const OctaveBandAnalyzer& bandsToUse) noexcept
+{
+    const auto available = bandsToUse.getNumPowerSteps();
+
+    // The band analyzer was reset since the previous call
+    if (available < numPowerStepsRead)
+        numPowerStepsRead = 0;
+
+    for (auto index = juce::jmax(numPowerStepsRead, available - OctaveBandAnalyzer::powerRingSize); index < available; ++index)
+        processStep(bandsToUse.getPowerStep(index) + firstBand);
+
+    numPowerStepsRead = available;
+}
+
+float ZwickerLoudness::calculateStationaryLoudness(const float* thirdOctaveLevels) noexcept
+{
+    // The same chain without the band smoothing and the temporal stages
+    calculateCoreLoudness(thirdOctaveLevels);
+    return calculateSpecificLoudness(coreLoudness);
+}
+
+float ZwickerLoudness::getPercentileLoudness(float percent) const noexcept
+{
+    if (numSteps == 0)
+        return 0.0f;
+
+    // Walk down from the loudest bin until the given share of the steps is above it
+    const auto target = static_cast<double>(numSteps) * juce::jlimit(0.0f, 100.0f, percent) / 100.0;
+    juce::uint64 count = 0;
+
+    for (int bin = histogramSize - 1; bin > 0; --bin)
+    {
+        count += histogram[(size_t)bin];
+
+        if (static_cast<double>(count) > target)
+            return levelToLoudness(histogramMin + (static_cast<float>(bin) + 0.5f) * histogramStep);
+    }
+
+    return levelToLoudness(histogramMin + 0.5f * histogramStep);
+}
+
+//==============================================================================
+void ZwickerLoudness::processStep(const float* meanSquares) noexcept
+{
+    // Square-and-smooth of the standard, applied to the 2 ms mean squares
+    auto* input = meanSquares;
+
+    for (auto& stage : smoothed)
+    {
+        for (size_t i = 0; i < (size_t)numBands; ++i)
+            stage[i] = input[i] + smoothing[i] * (stage[i] - input[i]);
+
+        input = stage.data();
+    }
+
+    const auto& power = smoothed.back();
+    std::array<float, numBands> bandLevels;
+
+    for (size_t i = 0; i < (size_t)numBands; ++i)
+        bandLevels[i] = 10.0f * std::log10(juce::jmax(power[i], 1.0e-12f)) + options.fullScaleLevel;
+
+    calculateCoreLoudness(bandLevels.data());
+    applyTemporalDecay();
+    instantaneousLoudness = calculateSpecificLoudness(decayOutput);
+
+    fastLoudness = instantaneousLoudness + fastWeighting * (fastLoudness - instantaneousLoudness);
+    slowLoudness = instantaneousLoudness + slowWeighting * (slowLoudness - instantaneousLoudness);
+    loudness = fastWeightingShare * fastLoudness + (1.0f - fastWeightingShare) * slowLoudness;
+
+    const auto bin = juce::jlimit(0, histogramSize - 1, static_cast<int>((loudnessToLevel(loudness) - histogramMin) / histogramStep));
+    ++histogram[(size_t)bin];
+    ++numSteps;
+    maxLoudness = juce::jmax(maxLoudness, loudness);
+}
+
+void ZwickerLoudness::calculateCoreLoudness(const float* bandLevels) noexcept
+{
+    // Bands up to 250 Hz get their equal-loudness correction, then merge into the lowest three critical bands
+    std::array<float, 3> lowIntensities{};
+
+    for (int i = 0; i < numLowBands; ++i)
+    {
+        int range = 0;
+
+        while (range < numCorrectionRanges - 1 && bandLevels[i] > correctionRanges[range] - lowFrequencyCorrections[range][i])
+            ++range;
+
+        const auto group = i < 6 ? 0 : (i < 9 ? 1 : 2);
+        lowIntensities[(size_t)group] += std::pow(10.0f, 0.1f * (bandLevels[i] + lowFrequencyCorrections[range][i]));
+    }
+
+    for (size_t i = 0; i < lowIntensities.size(); ++i)
+        levels[i] = 10.0f * std::log10(juce::jmax(lowIntensities[i], 1.0e-12f));
+
+    for (int i = 3; i < numCriticalBands; ++i)
+        levels[(size_t)i] = bandLevels[numLowBands + i - 3];
+
+    // Core loudness of the bands above the threshold in quiet; the offsets include the band adaptation
+    for (size_t i = 0; i < (size_t)numCriticalBands; ++i)
+    {
+        const auto excess = levels[i] + levelOffset[i] - threshold[i];
+        const auto excitation = std::pow(1.0f - coreLoudnessSlope + coreLoudnessSlope * std::pow(10.0f, 0.1f * excess), coreLoudnessExponent);
+        coreLoudness[i] = excess + criticalBandAdaptation[i] > 0.0f ? juce::jmax(0.0f, thresholdGain[i] * (excitation - 1.0f)) : 0.0f;
+    }
+
+    // The lowest critical band is only partly audible
+    coreLoudness[0] *= juce::jmin(1.0f, 0.4f + 0.32f * std::pow(coreLoudness[0], 0.2f));
+}
+
+void ZwickerLoudness::applyTemporalDecay() noexcept
+{
+    for (size_t i = 0; i < (size_t)numCriticalBands; ++i)
+    {
+        const auto input = coreLoudness[i];
+        auto output = decayOutput[i];
+        auto state = decayState[i];
+
+        if (input < output)
+        {
+            if (output > state)
+            {
+                // Falling after a short rise: the faster two-pole decay
+                const auto nextOutput = output * decayB2 - state * decayB3;
+                state = output * decayB0 - state * decayB1;
+                output = juce::jmax(input, nextOutput);
+                state = juce::jmin(state, output);
+            }
+            else
+            {
+                output = juce::jmax(input, output * decayLong);
+                state = output;
+            }
+        }
+        else
+        {
+            state = output > state || input > output ? input + decayShort * (state - input) : input;
+            output = input;
+        }
+
+        decayOutput[i] = output;
+        decayState[i] = state;
+    }
+}
+
+float ZwickerLoudness::calculateSpecificLoudness(const std::array<float, numCriticalBands>& bandCores) noexcept
+{
+    // Walks up the critical bands, flat over each band and falling along the upper slopes
+    // after a louder one, writing the pattern every 0.1 Bark and integrating the total
+    float total = 0.0f, previousLoudness = 0.0f, previousEdge = 0.0f;
+    int range = numSlopeRanges - 1;
+    int next = 0;
+
+    auto fill = [this, &next](float upTo, auto&& valueAt)
+        {
+            for (; next < numSpecificLoudnessValues && static_cast<float>(next + 1) * barkStep <= upTo; ++next)
+                specificLoudness[(size_t)next] = valueAt(static_cast<float>(next + 1) * barkStep);
+        };
+
+    for (int band = 0; band <= numCriticalBands; ++band)
+    {
+        const auto edge = upperEdges[band] + 0.0001f;
+        const auto core = band < numCriticalBands ? bandCores[(size_t)band] : 0.0f;
+        const auto group = juce::jlimit(0, numSlopeGroups - 1, band - 1);
+
+        while (previousEdge < edge)
+        {
+            float bandLoudness, bandEdge;
+
+            if (previousLoudness <= core)
+            {
+                if (previousLoudness < core)
+                {
+                    range = 0;
+
+                    while (range < numSlopeRanges - 1 && slopeRanges[range] > core)
+                        ++range;
+                }
+
+                bandEdge = edge;
+                bandLoudness = core;
+                total += core * (bandEdge - previousEdge);
+                fill(bandEdge, [core](float) { return core; });
+            }
+            else
+            {
+                const auto slope = upperSlopes[range][group];
+                bandLoudness = juce::jmax(slopeRanges[range], core);
+                auto width = (previousLoudness - bandLoudness) / slope;
+                bandEdge = previousEdge + width;
+
+                if (bandEdge > edge)
+                {
+                    bandEdge = edge;
+                    width = bandEdge - previousEdge;
+                    bandLoudness = previousLoudness - width * slope;
+                }
+
+                total += width * (previousLoudness + bandLoudness) * 0.5f;
+                fill(bandEdge, [previousLoudness, previousEdge, slope](float z) { return previousLoudness - (z - previousEdge) * slope; });
+            }
+
+            if (bandLoudness <= slopeRanges[range] && range < numSlopeRanges - 1)
+                ++range;
+
+            previousLoudness = bandLoudness;
+            previousEdge = bandEdge;
+        }
+    }
+
+    return juce::jmax(0.0f, total);
+}
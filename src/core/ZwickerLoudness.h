@@ -0,0 +1,148 @@
+#pragma once
+
+#include "OctaveBandAnalyzer.h"
+#include <array>
+
+//==============================================================================
+/**
+    Time-varying loudness after the Zwicker method of ISO 532-1, in sone and phon, with
+    the specific loudness over critical-band rate and the N5 and N10 percentiles.
+
+    It runs on the 2 ms band power steps of an OctaveBandAnalyzer, 25 Hz to 12.5 kHz, so
+    it needs no filters of its own. Every step goes through the chain of the standard:
+    the band smoothing (three first-order low-passes per band, applied to the 2 ms mean
+    squares), the equal-loudness corrections and grouping of the bands below 315 Hz,
+    core loudness per critical band, the nonlinear temporal decay, the upper slopes of
+    the specific loudness pattern from the standard's USL table, by specific loudness
+    range and critical band, and the 3.5 ms / 70 ms temporal weighting of the total.
+    calculateStationaryLoudness() runs the same tables on given third-octave levels, as
+    the stationary method does. Levels are relative to Options::fullScaleLevel, so the
+    results only mean something once that matches the calibration of the input.
+
+    All the constants of the standard are precomputed per band in prepare(), so a step is
+    a few flat loops over 20 bands plus the slope walk over 240 values of 0.1 Bark.
+    Percentiles come from a 0.1 phon histogram of every step since resetStatistics(), so
+    memory stays constant however long the session. Nothing allocates after prepare().
+
+    The specific loudness of the latest step is public so sharpness and annoyance models
+    can use it instead of computing their own.
+*/
+class ZwickerLoudness
+{
+public:
+    enum class SoundField
+    {
+        free,
+        diffuse
+    };
+
+    struct Options
+    {
+        float fullScaleLevel = 100.0f;  // dB SPL of a full-scale RMS of 1
+        SoundField soundField = SoundField::free;
+    };
+
+    static constexpr int numCriticalBands = 20;
+    static constexpr int numSpecificLoudnessValues = 240;  // 0.1 Bark steps up to 24 Bark
+    static constexpr float barkStep = 0.1f;
+
+    ZwickerLoudness() = default;
+
+    /** Precomputes the band tables for a prepared OctaveBandAnalyzer. Not real-time safe. */
+    void prepare(const OctaveBandAnalyzer& bandsToUse, const Options& optionsToUse);
+    void prepare(const OctaveBandAnalyzer& bandsToUse) { prepare(bandsToUse, Options()); }
+
+    /** Clears the filters and the statistics. */
+    void reset() noexcept;
+
+    /** Restarts the percentiles and the maximum only. */
+    void resetStatistics() noexcept;
+
+    /**
+        Runs every power step the band analyzer completed since the previous call. Steps
+        that already left its ring are skipped, so call it at least every powerRingSize steps.
+    */
+    void process(const OctaveBandAnalyzer& bandsToUse) noexcept;
+
+    /** Temporally weighted total loudness of the latest step, sone. */
+    float getLoudness() const noexcept { return loudness; }
+
+    /** Loudness level of the latest step, phon. */
+    float getLoudnessLevel() const noexcept { return loudnessToLevel(loudness); }
+
+    /** Loudness exceeded during the given percentage of the steps since resetStatistics(), e.g. 5 for N5. */
+    float getPercentileLoudness(float percent) const noexcept;
+
+    float getMaxLoudness() const noexcept { return maxLoudness; }
+
+    /** Specific loudness of the latest step, sone per Bark, at 0.1 Bark to 24 Bark. */
+    const float* getSpecificLoudness() const noexcept { return specificLoudness.data(); }
+
+    /** Total loudness of the latest step before the temporal weighting, sone. */
+    float getInstantaneousLoudness() const noexcept { return instantaneousLoudness; }
+
+    /**
+        Stationary loudness in sone of 28 third-octave levels, 25 Hz to 12.5 kHz in dB SPL.
+        It overwrites the specific loudness pattern, but not the temporal stages or the
+        statistics. Call after prepare().
+    */
+    float calculateStationaryLoudness(const float* thirdOctaveLevels) noexcept;
+
+    /** dB SPL of a full-scale RMS of 1. Takes effect from the next step. */
+    void setFullScaleLevel(float newLevel) noexcept { options.fullScaleLevel = newLevel; }
+
+    const Options& getOptions() const noexcept { return options; }
+
+    /** ISO 532-1 loudness level: 40 phon at 1 sone, 10 phon per doubling above, a power law below. */
+    static float loudnessToLevel(float sones) noexcept;
+    static float levelToLoudness(float phons) noexcept;
+
+private:
+    static constexpr int numBands = 28;         // third-octaves 25 Hz to 12.5 kHz
+    static constexpr int firstBand = 1;         // index of 25 Hz in the OctaveBandAnalyzer
+    static constexpr int numLowBands = 11;      // 25 Hz to 250 Hz, grouped into three critical bands
+    static constexpr int numSlopeRanges = 18;   // specific loudness ranges of the upper slopes
+    static constexpr int numSlopeGroups = 8;    // critical band groups of the upper slopes
+
+    static constexpr float histogramMin = 0.0f;    // phon
+    static constexpr float histogramStep = 0.1f;
+    static constexpr int histogramSize = 1400;     // 0 to 140 phon
+
+    void processStep(const float* meanSquares) noexcept;
+    void calculateCoreLoudness(const float* bandLevels) noexcept;
+    void applyTemporalDecay() noexcept;
+    float calculateSpecificLoudness(const std::array<float, numCriticalBands>& bandCores) noexcept;
+
+    Options options;
+
+    // Band smoothing: three cascaded one-poles per third-octave, coefficient exp(-T / tau)
+    std::array<float, numBands> smoothing{};
+    std::array<std::array<float, numBands>, 3> smoothed{};
+
+    // Core loudness per critical band, from the precomputed ear and threshold tables
+    std::array<float, numCriticalBands> levelOffset{};     // ear transmission, free to diffuse and critical band adaptation
+    std::array<float, numCriticalBands> threshold{};       // threshold in quiet, LTQ
+    std::array<float, numCriticalBands> thresholdGain{};   // 0.0635 * 10^(0.025 LTQ)
+    std::array<float, numCriticalBands> levels{};
+    std::array<float, numCriticalBands> coreLoudness{};
+
+    // Nonlinear temporal decay: output and the slow state per critical band
+    std::array<float, numCriticalBands> decayOutput{}, decayState{};
+    float decayB0 = 0.0f, decayB1 = 0.0f, decayB2 = 0.0f, decayB3 = 0.0f, decayLong = 0.0f, decayShort = 0.0f;
+
+    std::array<float, numSpecificLoudnessValues> specificLoudness{};
+    float instantaneousLoudness = 0.0f;
+
+    // Temporal weighting of the total, 0.47 of a 3.5 ms and 0.53 of a 70 ms low-pass
+    float fastWeighting = 0.0f, slowWeighting = 0.0f;
+    float fastLoudness = 0.0f, slowLoudness = 0.0f;
+    float loudness = 0.0f;
+
+    std::array<juce::uint32, histogramSize> histogram{};
+    juce::uint64 numSteps = 0;
+    float maxLoudness = 0.0f;
+
+    juce::int64 numPowerStepsRead = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ZwickerLoudness)
+};
@@ -0,0 +1,65 @@
+#include "AnalysisWorker.h"
+
+//==============================================================================
+class AnalysisWorkerTests : public juce::UnitTest
+{
+public:
+    AnalysisWorkerTests() : juce::UnitTest("AnalysisWorker", "AcousticAnalysisCore") {}
+
+    void runTest() override
+    {
+        beginTest("Dropped samples are reported where they went missing");
+
+        constexpr int blockSize = 100;
+        constexpr int numBlocks = 64;
+        constexpr int totalSamples = blockSize * numBlocks;
+
+        // Every sample holds its own stream position, so the consumer can tell whether
+        // its count, including the reported drops, still matches the stream
+        std::atomic<juce::int64> position{ 0 };
+        std::atomic<int> numMismatches{ 0 };
+
+        AnalysisWorker worker([&](const float* const* channels, int, int numSamples)
+            {
+                const auto start = position.load();
+
+                for (int i = 0; i < numSamples; ++i)
+                    if (channels[0][i] != static_cast<float>(start + i))
+                        ++numMismatches;
+
+                position += numSamples;
+            },
+            [&](int numSamples) { position += numSamples; });
+
+        // Much smaller than what is pushed before the worker's first poll, so samples are dropped
+        worker.prepare(1, 256);
+
+        std::vector<float> block((size_t)blockSize);
+
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            for (int i = 0; i < blockSize; ++i)
+                block[(size_t)i] = static_cast<float>(b * blockSize + i);
+
+            const float* channels[] = { block.data() };
+            worker.push(channels, 1, blockSize);
+        }
+
+        // A gap at the end is reported when the next samples arrive; by now there is room for them
+        juce::Thread::sleep(100);
+        block[0] = static_cast<float>(totalSamples);
+        const float* channels[] = { block.data() };
+        worker.push(channels, 1, 1);
+
+        for (int i = 0; i < 200 && position.load() < totalSamples + 1; ++i)
+            juce::Thread::sleep(10);
+
+        worker.release();
+
+        expectEquals(position.load(), static_cast<juce::int64>(totalSamples + 1));
+        expectEquals(numMismatches.load(), 0);
+        logMessage(juce::String(worker.getNumDroppedSamples()) + " samples dropped");
+    }
+};
+
+static AnalysisWorkerTests analysisWorkerTests;
@@ -0,0 +1,90 @@
+#include "LoudnessMeter.h"
+#include <vector>
+
+//==============================================================================
+class LoudnessMeterTests : public juce::UnitTest
+{
+public:
+    LoudnessMeterTests() : juce::UnitTest("LoudnessMeter", "AcousticAnalysisCore") {}
+
+    void runTest() override
+    {
+        beginTest("A 997 Hz sine at -20 dBFS in one channel reads -23 LUFS");
+        {
+            LoudnessMeter meter;
+            meter.prepare(sampleRate, 2);
+            feed(meter, 0.1, 20.0);
+
+            expectWithinAbsoluteError(meter.getMomentaryLoudness(), -23.0f, 0.1f);
+            expectWithinAbsoluteError(meter.getShortTermLoudness(), -23.0f, 0.1f);
+            expectWithinAbsoluteError(meter.getIntegratedLoudness(), -23.0f, 0.1f);
+        }
+
+        beginTest("The absolute gate leaves silence out of the integrated loudness");
+        {
+            LoudnessMeter meter;
+            meter.prepare(sampleRate, 2);
+            feed(meter, 0.1, 10.0);
+            feed(meter, 0.0, 10.0);
+
+            expectEquals(meter.getMomentaryLoudness(), LoudnessMeter::minimumLoudness);
+            expectWithinAbsoluteError(meter.getIntegratedLoudness(), -23.0f, 0.1f);
+        }
+
+        beginTest("The relative gate leaves passages 30 dB down out of the integrated loudness");
+        {
+            LoudnessMeter meter;
+            meter.prepare(sampleRate, 2);
+            feed(meter, 0.1, 10.0);
+            feed(meter, 0.1 * std::pow(10.0, -30.0 / 20.0), 10.0);
+
+            expectWithinAbsoluteError(meter.getIntegratedLoudness(), -23.0f, 0.2f);
+        }
+
+        beginTest("20 s at -20 LUFS then 20 s at -30 LUFS have a loudness range of 10 LU");
+        {
+            LoudnessMeter meter;
+            meter.prepare(sampleRate, 2);
+            feed(meter, getAmplitudeForLoudness(-20.0), 20.0);
+            feed(meter, getAmplitudeForLoudness(-30.0), 20.0);
+
+            expectWithinAbsoluteError(meter.getLoudnessRange(), 10.0f, 1.0f);
+        }
+
+        beginTest("A constant level has no loudness range");
+        {
+            LoudnessMeter meter;
+            meter.prepare(sampleRate, 2);
+            feed(meter, getAmplitudeForLoudness(-20.0), 20.0);
+
+            expectWithinAbsoluteError(meter.getLoudnessRange(), 0.0f, 0.1f);
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr double frequency = 997.0;
+
+    /** Peak amplitude of a 997 Hz sine in one channel that reads the given loudness. */
+    static double getAmplitudeForLoudness(double lufs) { return std::pow(10.0, (lufs + 3.01) / 20.0); }
+
+    /** A sine of the given peak amplitude in the left channel and silence in the right. */
+    void feed(LoudnessMeter& meter, double amplitude, double seconds)
+    {
+        constexpr int blockSize = 480;
+        std::vector<float> left((size_t)blockSize), right((size_t)blockSize, 0.0f);
+        const float* channels[] = { left.data(), right.data() };
+
+        for (int block = 0; block < static_cast<int>(seconds * sampleRate) / blockSize; ++block)
+        {
+            for (auto& sample : left)
+                sample = static_cast<float>(amplitude * std::sin(juce::MathConstants<double>::twoPi * frequency * static_cast<double>(position++) / sampleRate));
+
+            meter.process(channels, 2, blockSize);
+        }
+    }
+
+    juce::int64 position = 0;
+};
+
+static LoudnessMeterTests loudnessMeterTests;
@@ -0,0 +1,24 @@
+#include <juce_core/juce_core.h>
+
+//==============================================================================
+// Runs every juce::UnitTest registered in this executable. The exit code is the
+// number of failed tests, so ctest reports any failure.
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+
+    if (args.containsOption("--category"))
+        runner.runTestsInCategory(args.getValueForOption("--category"));
+    else
+        runner.runAllTests();
+
+    int numFailures = 0;
+
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        numFailures += runner.getResult(i)->failures;
+
+    return juce::jmin(numFailures, 255);
+}
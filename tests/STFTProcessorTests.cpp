@@ -0,0 +1,59 @@
+#include "STFTProcessor.h"
+#include <algorithm>
+
+//==============================================================================
+class STFTProcessorTests : public juce::UnitTest
+{
+public:
+    STFTProcessorTests() : juce::UnitTest("STFTProcessor", "AcousticAnalysisCore") {}
+
+    void runTest() override
+    {
+        constexpr int fftOrder = 11;
+        constexpr int fftSize = 1 << fftOrder;
+        constexpr int hopSize = fftSize / 4;
+        constexpr int numSamples = 48000;
+
+        std::vector<float> signal((size_t)numSamples);
+
+        // A sine centred on bin 64
+        for (int i = 0; i < numSamples; ++i)
+            signal[(size_t)i] = std::sin(juce::MathConstants<float>::twoPi * 64.0f * static_cast<float>(i) / fftSize);
+
+        beginTest("One frame per hop once a full window has arrived, whatever the block size");
+        {
+            const int expectedFrames = (numSamples - fftSize) / hopSize + 1;
+
+            for (const auto blockSize : { 1, 37, 512, 4096, numSamples })
+            {
+                STFTProcessor stft(fftOrder);
+                stft.setHopSize(hopSize);
+
+                int numFrames = 0;
+
+                for (int pos = 0; pos < numSamples; pos += blockSize)
+                    stft.process(signal.data() + pos, juce::jmin(blockSize, numSamples - pos), [&](const float*) { ++numFrames; });
+
+                expectEquals(numFrames, expectedFrames, "block size " + juce::String(blockSize));
+                expectEquals(stft.getNumSamplesProcessed(), static_cast<juce::int64>(numSamples));
+            }
+        }
+
+        beginTest("A sine peaks in its own bin");
+        {
+            STFTProcessor stft(fftOrder);
+            stft.setHopSize(hopSize);
+
+            int peakBin = -1;
+
+            stft.process(signal.data(), fftSize, [&](const float* magnitudes)
+                {
+                    peakBin = static_cast<int>(std::max_element(magnitudes, magnitudes + stft.getNumBins()) - magnitudes);
+                });
+
+            expectEquals(peakBin, 64);
+        }
+    }
+};
+
+static STFTProcessorTests stftProcessorTests;
@@ -0,0 +1,102 @@
+#include "SeqLock.h"
+#include <thread>
+#include <vector>
+
+//==============================================================================
+class SeqLockTests : public juce::UnitTest
+{
+public:
+    SeqLockTests() : juce::UnitTest("SeqLock", "AcousticAnalysisCore") {}
+
+    void runTest() override
+    {
+        beginTest("Loads return the latest store");
+        {
+            SeqLock<Value> lock;
+            expectEquals(lock.getVersion(), juce::uint64(1));
+            expect(isConsistent(lock.load(), 0));
+
+            lock.store(makeValue(42));
+            expectEquals(lock.getVersion(), juce::uint64(2));
+            expect(isConsistent(lock.load(), 42));
+        }
+
+        beginTest("Concurrent readers never see a torn value");
+        {
+            constexpr juce::uint64 numStores = 200000;
+            constexpr int numReaders = 3;
+
+            SeqLock<Value> lock;
+            std::atomic<bool> writerDone{ false };
+            std::atomic<int> numTornReads{ 0 };
+            std::atomic<int> numOutOfOrderReads{ 0 };
+            std::atomic<juce::int64> numReads{ 0 };
+
+            std::vector<std::thread> readers;
+
+            for (int r = 0; r < numReaders; ++r)
+            {
+                readers.emplace_back([&]
+                    {
+                        juce::uint64 previous = 0;
+
+                        while (!writerDone.load())
+                        {
+                            const auto value = lock.load();
+
+                            // Every word of a store holds the same number, so a mix of two stores shows up here
+                            if (!isConsistent(value, value.words[0]))
+                                ++numTornReads;
+
+                            // Stores only count up, so a reader must never go back to an older one
+                            if (value.words[0] < previous)
+                                ++numOutOfOrderReads;
+
+                            previous = value.words[0];
+                            ++numReads;
+                        }
+                    });
+            }
+
+            // Writes back to back, so readers keep overlapping a store and have to retry
+            for (juce::uint64 i = 1; i <= numStores; ++i)
+                lock.store(makeValue(i));
+
+            writerDone.store(true);
+
+            for (auto& reader : readers)
+                reader.join();
+
+            expectEquals(numTornReads.load(), 0);
+            expectEquals(numOutOfOrderReads.load(), 0);
+            expectGreaterThan(numReads.load(), juce::int64(0));
+            expect(isConsistent(lock.load(), numStores));
+            expectEquals(lock.getVersion(), numStores + 1);
+        }
+    }
+
+private:
+    // Larger than a cache line, like the FeatureSnapshot the plugin publishes
+    struct Value
+    {
+        std::array<juce::uint64, 13> words;
+    };
+
+    static Value makeValue(juce::uint64 number)
+    {
+        Value value;
+        value.words.fill(number);
+        return value;
+    }
+
+    static bool isConsistent(const Value& value, juce::uint64 number)
+    {
+        for (auto word : value.words)
+            if (word != number)
+                return false;
+
+        return true;
+    }
+};
+
+static SeqLockTests seqLockTests;
@@ -0,0 +1,89 @@
+#include "SessionFile.h"
+
+//==============================================================================
+class SessionFileTests : public juce::UnitTest
+{
+public:
+    SessionFileTests() : juce::UnitTest("SessionFile", "AcousticAnalysisCore") {}
+
+    void runTest() override
+    {
+        constexpr int rowsPerChunk = 16;
+        constexpr int numRows = 40;
+
+        const juce::TemporaryFile tempFile(".aas");
+        const auto& file = tempFile.getFile();
+
+        {
+            juce::FileOutputStream stream(file);
+
+            SessionFileWriter writer(stream, rowsPerChunk);
+
+            for (int i = 0; i < numRows; ++i)
+            {
+                DataPoint point{};
+                point.timestamp = i * 0.025;
+                point.activationScore = static_cast<float>(i);
+                writer.addPoint(point);
+            }
+
+            writer.finish();
+        }
+
+        beginTest("Round trip");
+        {
+            SessionFileReader reader(file);
+            expect(reader.isValid(), reader.getError());
+            expectEquals(reader.getNumRows(), static_cast<juce::int64>(numRows));
+            expectEquals(reader.getNumChunks(), 3);
+
+            const auto column = reader.findColumn("Activation_Score");
+            expectEquals(reader.getValue(column, numRows - 1), static_cast<double>(numRows - 1));
+            expectEquals(reader.findRowAtTime(0.49), static_cast<juce::int64>(20));
+        }
+
+        juce::MemoryBlock original;
+        file.loadFileAsData(original);
+
+        const auto& header = *static_cast<const SessionFormat::Header*>(original.getData());
+        const auto chunkIndexOffset = static_cast<size_t>(header.chunkIndexOffset);
+
+        // Each corruption is applied to a fresh copy of the file and must be rejected
+        auto expectRejected = [&](const juce::String& name, auto&& corrupt)
+            {
+                juce::MemoryBlock copy(original);
+                corrupt(static_cast<char*>(copy.getData()));
+                file.replaceWithData(copy.getData(), copy.getSize());
+
+                SessionFileReader reader(file);
+                expect(!reader.isValid(), name + " was accepted");
+            };
+
+        auto chunkAt = [chunkIndexOffset](char* data, int chunk)
+            {
+                return reinterpret_cast<SessionFormat::ChunkEntry*>(data + chunkIndexOffset) + chunk;
+            };
+
+        beginTest("Corrupt headers and chunk indices are rejected");
+        {
+            expectRejected("A chunk longer than rowsPerChunk", [&](char* data) { chunkAt(data, 2)->numRows = rowsPerChunk + 1; });
+            expectRejected("A short chunk before the last", [&](char* data) { chunkAt(data, 0)->numRows = rowsPerChunk - 1; });
+            expectRejected("A gap between chunks", [&](char* data) { chunkAt(data, 1)->firstRow += 1; });
+            expectRejected("A row count the chunks don't add up to", [&](char* data) { reinterpret_cast<SessionFormat::Header*>(data)->numRows += 1; });
+            expectRejected("Zero rows per chunk", [&](char* data) { reinterpret_cast<SessionFormat::Header*>(data)->rowsPerChunk = 0; });
+            expectRejected("An index offset that overflows", [&](char* data) { reinterpret_cast<SessionFormat::Header*>(data)->chunkIndexOffset = ~juce::uint64(0) - 7; });
+            expectRejected("A chunk offset that overflows", [&](char* data) { chunkAt(data, 1)->fileOffset = ~juce::uint64(0) - 63; });
+        }
+
+        beginTest("Truncated files are rejected");
+        {
+            for (auto keep : { size_t(0), sizeof(SessionFormat::Header), chunkIndexOffset, original.getSize() - 1 })
+            {
+                file.replaceWithData(original.getData(), keep);
+                expect(!SessionFileReader(file).isValid(), "Truncated to " + juce::String((int)keep) + " bytes");
+            }
+        }
+    }
+};
+
+static SessionFileTests sessionFileTests;
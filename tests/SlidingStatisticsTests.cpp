@@ -0,0 +1,67 @@
+#include "SlidingStatistics.h"
+#include <vector>
+
+//==============================================================================
+class SlidingStatisticsTests : public juce::UnitTest
+{
+public:
+    SlidingStatisticsTests() : juce::UnitTest("SlidingStatistics", "AcousticAnalysisCore") {}
+
+    void runTest() override
+    {
+        beginTest("Every window matches a brute-force window over a long random stream");
+        {
+            const int lengths[] = { 1, 2, 7, 250, 6000 };
+            constexpr int numValues = 500000;
+
+            SlidingStatistics statistics;
+            statistics.prepare(lengths, (int)std::size(lengths));
+
+            // A large offset with small changes is the worst case for the sliding corrections
+            juce::Random random(0x5eed);
+            std::vector<float> values;
+            values.reserve((size_t)numValues);
+
+            for (int n = 0; n < numValues; ++n)
+            {
+                values.push_back(1000.0f + random.nextFloat() * (n % 50000 < 25000 ? 1.0f : 0.001f));
+                statistics.add(values.back());
+
+                if (n % 9973 != 0 && n != numValues - 1)
+                    continue;
+
+                for (int window = 0; window < statistics.getNumWindows(); ++window)
+                {
+                    const auto count = juce::jmin(lengths[window], n + 1);
+                    const auto first = values.begin() + (n + 1 - count);
+
+                    double sum = 0.0;
+                    for (auto it = first; it != values.end(); ++it)
+                        sum += *it;
+
+                    const auto mean = sum / count;
+                    double squares = 0.0, differences = 0.0;
+
+                    for (auto it = first; it != values.end(); ++it)
+                    {
+                        squares += (*it - mean) * (*it - mean);
+
+                        if (it != first)
+                            differences += std::abs((double)*it - (double)*(it - 1));
+                    }
+
+                    const auto variance = squares / count;
+                    const auto meanDifference = count > 1 ? differences / (count - 1) : 0.0;
+                    const auto message = "window " + juce::String(lengths[window]) + " after " + juce::String(n + 1);
+
+                    expectEquals(statistics.getCount(window), count, message);
+                    expectWithinAbsoluteError(statistics.getMean(window), mean, 1.0e-9, message);
+                    expectWithinAbsoluteError(statistics.getVariance(window), variance, 1.0e-6 * variance + 1.0e-12, message);
+                    expectWithinAbsoluteError(statistics.getMeanAbsoluteDifference(window), meanDifference, 1.0e-6 * meanDifference + 1.0e-12, message);
+                }
+            }
+        }
+    }
+};
+
+static SlidingStatisticsTests slidingStatisticsTests;
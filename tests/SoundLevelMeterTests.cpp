@@ -0,0 +1,59 @@
+#include "SoundLevelMeter.h"
+#include <vector>
+
+//==============================================================================
+class SoundLevelMeterTests : public juce::UnitTest
+{
+public:
+    SoundLevelMeterTests() : juce::UnitTest("SoundLevelMeter", "AcousticAnalysisCore") {}
+
+    void runTest() override
+    {
+        beginTest("A-weighting is 0 dB at 1 kHz");
+        {
+            const auto levels = measure(1000.0);
+            expectWithinAbsoluteError(levels.z, -3.01f, 0.05f);
+            expectWithinAbsoluteError(levels.a - levels.z, 0.0f, 0.1f);
+            expectWithinAbsoluteError(levels.c - levels.z, 0.0f, 0.1f);
+        }
+
+        beginTest("A-weighting is -19.1 dB at 100 Hz");
+        {
+            const auto levels = measure(100.0);
+            expectWithinAbsoluteError(levels.a - levels.z, -19.1f, 0.2f);
+            expectWithinAbsoluteError(levels.c - levels.z, -0.3f, 0.2f);
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+
+    struct Levels
+    {
+        float a, c, z;
+    };
+
+    /** 1 s Leqs of two seconds of a full-scale sine. */
+    static Levels measure(double frequency)
+    {
+        SoundLevelMeter meter;
+        meter.prepare(sampleRate);
+
+        std::vector<float> block(480);
+        juce::int64 position = 0;
+
+        for (int n = 0; n < 2 * static_cast<int>(sampleRate) / (int)block.size(); ++n)
+        {
+            for (auto& sample : block)
+                sample = static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * frequency * static_cast<double>(position++) / sampleRate));
+
+            meter.process(block.data(), (int)block.size());
+        }
+
+        return { meter.getEquivalentLevel(SoundLevelMeter::Weighting::a, 0),
+                 meter.getEquivalentLevel(SoundLevelMeter::Weighting::c, 0),
+                 meter.getEquivalentLevel(SoundLevelMeter::Weighting::z, 0) };
+    }
+};
+
+static SoundLevelMeterTests soundLevelMeterTests;
@@ -0,0 +1,56 @@
+#include "StreamingQuantile.h"
+#include <algorithm>
+#include <vector>
+
+//==============================================================================
+class StreamingQuantileTests : public juce::UnitTest
+{
+public:
+    StreamingQuantileTests() : juce::UnitTest("StreamingQuantile", "AcousticAnalysisCore") {}
+
+    void runTest() override
+    {
+        beginTest("The first five values are exact");
+        {
+            StreamingQuantile median(0.5);
+
+            for (auto value : { 5.0, 1.0, 4.0 })
+                median.add(value);
+
+            expectEquals(median.getQuantile(), 4.0);
+        }
+
+        beginTest("Estimates match the exact quantiles of uniform and exponential streams");
+        {
+            juce::Random random(0x9e3779b9);
+            std::vector<double> uniform, exponential;
+
+            for (int i = 0; i < 100000; ++i)
+            {
+                const auto u = random.nextDouble();
+                uniform.push_back(u);
+                exponential.push_back(-std::log(1.0 - u));
+            }
+
+            for (const auto* values : { &uniform, &exponential })
+            {
+                auto sorted = *values;
+                std::sort(sorted.begin(), sorted.end());
+
+                for (auto probability : { 0.1, 0.5, 0.9, 0.95 })
+                {
+                    StreamingQuantile quantile(probability);
+
+                    for (auto value : *values)
+                        quantile.add(value);
+
+                    const auto exact = sorted[(size_t)(probability * static_cast<double>(sorted.size() - 1))];
+                    expectWithinAbsoluteError(quantile.getQuantile(), exact, 0.02 * exact + 0.002,
+                                              "p = " + juce::String(probability));
+                }
+            }
+        }
+    }
+};
+
+static StreamingQuantileTests streamingQuantileTests;
@@ -0,0 +1,55 @@
+#include "TimeWeighting.h"
+#include <vector>
+
+//==============================================================================
+class TimeWeightingTests : public juce::UnitTest
+{
+public:
+    TimeWeightingTests() : juce::UnitTest("TimeWeighting", "AcousticAnalysisCore") {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 48000.0;
+
+        TimeWeighting weighting;
+        weighting.prepare(sampleRate, 1);
+
+        // Settle every integrator on a mean square of 1, then let it decay
+        feed(weighting, 1.0, static_cast<int>(10.0 * sampleRate));
+
+        beginTest("Every time weighting settles on a steady signal");
+        {
+            for (auto mode : { TimeWeighting::Mode::fast, TimeWeighting::Mode::slow, TimeWeighting::Mode::impulse })
+                expectWithinAbsoluteError(weighting.getMeanSquare(0, mode), 1.0, 1.0e-3);
+        }
+
+        beginTest("F decays at 34.7 dB/s and S at 4.3 dB/s");
+        {
+            feed(weighting, 0.0, static_cast<int>(0.5 * sampleRate));
+
+            // 10 log10(e) / tau dB per second
+            expectWithinAbsoluteError(toDecibels(weighting.getMeanSquare(0, TimeWeighting::Mode::fast)), -0.5 * 34.74, 0.1);
+            expectWithinAbsoluteError(toDecibels(weighting.getMeanSquare(0, TimeWeighting::Mode::slow)), -0.5 * 4.343, 0.05);
+            expectWithinAbsoluteError(toDecibels(weighting.getMeanSquare(0, TimeWeighting::Mode::impulse)), -0.5 * 2.895, 0.05);
+        }
+
+        beginTest("The maxima hold the steady level through the decay");
+        {
+            for (auto mode : { TimeWeighting::Mode::fast, TimeWeighting::Mode::slow, TimeWeighting::Mode::impulse })
+                expectWithinAbsoluteError(weighting.getMaxMeanSquare(0, mode), 1.0, 1.0e-3);
+        }
+    }
+
+private:
+    static double toDecibels(double meanSquare) { return 10.0 * std::log10(meanSquare); }
+
+    static void feed(TimeWeighting& weighting, double square, int numSamples)
+    {
+        std::vector<double> block(480, square);
+
+        for (int start = 0; start < numSamples; start += (int)block.size())
+            weighting.process(block.data(), juce::jmin((int)block.size(), numSamples - start));
+    }
+};
+
+static TimeWeightingTests timeWeightingTests;
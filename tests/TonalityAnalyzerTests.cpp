@@ -0,0 +1,70 @@
+#include "STFTProcessor.h"
+#include "TonalityAnalyzer.h"
+#include <vector>
+
+//==============================================================================
+class TonalityAnalyzerTests : public juce::UnitTest
+{
+public:
+    TonalityAnalyzerTests() : juce::UnitTest("TonalityAnalyzer", "AcousticAnalysisCore") {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int fftOrder = 11;
+        constexpr int fftSize = 1 << fftOrder;
+
+        beginTest("A tone in noise is one persistent tone above the ECMA-418-1 criteria");
+        {
+            STFTProcessor stft(fftOrder);
+            stft.setHopSize(fftSize / 2);
+
+            TonalityAnalyzer tonality;
+            tonality.prepare(sampleRate, fftSize);
+
+            // A 1 kHz tone 30 dB above white noise over the whole band
+            juce::Random random(42);
+            std::vector<float> signal(static_cast<size_t>(sampleRate));
+
+            for (size_t i = 0; i < signal.size(); ++i)
+                signal[i] = 0.1f * std::sin(juce::MathConstants<float>::twoPi * 1000.0f * static_cast<float>(i) / static_cast<float>(sampleRate))
+                          + 0.0054f * (2.0f * random.nextFloat() - 1.0f);
+
+            stft.process(signal.data(), (int)signal.size(), [&](const float* magnitudes) { tonality.process(magnitudes); });
+
+            expectEquals(tonality.getNumPersistentTones(), 1);
+
+            if (const auto* tone = tonality.getMostProminentTone())
+            {
+                expectWithinAbsoluteError(tone->frequency, 1000.0f, 10.0f);
+                expectGreaterThan(tone->toneToNoiseRatio, 8.0f);    // the TNR criterion at 1 kHz
+                expectGreaterThan(tone->prominence, 0.0f);
+            }
+            else
+            {
+                expect(false, "no prominent tone");
+            }
+        }
+
+        beginTest("Noise alone has no persistent tone");
+        {
+            STFTProcessor stft(fftOrder);
+            stft.setHopSize(fftSize / 2);
+
+            TonalityAnalyzer tonality;
+            tonality.prepare(sampleRate, fftSize);
+
+            juce::Random random(7);
+            std::vector<float> signal(static_cast<size_t>(sampleRate));
+
+            for (auto& sample : signal)
+                sample = 0.1f * (2.0f * random.nextFloat() - 1.0f);
+
+            stft.process(signal.data(), (int)signal.size(), [&](const float* magnitudes) { tonality.process(magnitudes); });
+
+            expectEquals(tonality.getNumPersistentTones(), 0);
+        }
+    }
+};
+
+static TonalityAnalyzerTests tonalityAnalyzerTests;
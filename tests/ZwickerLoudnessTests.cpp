@@ -0,0 +1,96 @@
+#include "ZwickerLoudness.h"
+#include <vector>
+
+//==============================================================================
+class ZwickerLoudnessTests : public juce::UnitTest
+{
+public:
+    ZwickerLoudnessTests() : juce::UnitTest("ZwickerLoudness", "AcousticAnalysisCore") {}
+
+    void runTest() override
+    {
+        constexpr int numBands = 28;
+        constexpr int band1kHz = 16;    // 25 Hz is the first band
+
+        OctaveBandAnalyzer bands;
+        bands.prepare(sampleRate);
+
+        beginTest("Stationary: a 1 kHz band at 40 dB is 1 sone, and its loudness level is its level");
+        {
+            ZwickerLoudness loudness;
+            loudness.prepare(bands);
+
+            for (const auto level : { 40.0f, 50.0f, 60.0f, 70.0f, 80.0f })
+            {
+                std::vector<float> levels((size_t)numBands, -100.0f);
+                levels[(size_t)band1kHz] = level;
+
+                const auto sones = loudness.calculateStationaryLoudness(levels.data());
+
+                if (level == 40.0f)
+                    expectWithinAbsoluteError(sones, 1.0f, 0.05f);
+
+                expectWithinAbsoluteError(ZwickerLoudness::loudnessToLevel(sones), level, 1.0f, juce::String(level) + " dB");
+            }
+        }
+
+        beginTest("Time-varying loudness of a steady tone settles on the stationary loudness of its bands");
+        {
+            for (const auto level : { 40.0, 60.0, 80.0 })
+            {
+                bands.reset();
+                ZwickerLoudness loudness;
+                loudness.prepare(bands);
+                runTone(bands, loudness, 1000.0, level);
+
+                const auto timeVarying = loudness.getLoudness();
+                const auto* meanSquares = bands.getPowerStep(bands.getNumPowerSteps() - 1) + 1;
+                std::vector<float> levels((size_t)numBands);
+
+                for (size_t i = 0; i < levels.size(); ++i)
+                    levels[i] = 10.0f * std::log10(juce::jmax(meanSquares[i], 1.0e-12f)) + loudness.getOptions().fullScaleLevel;
+
+                const auto stationary = loudness.calculateStationaryLoudness(levels.data());
+                expectWithinAbsoluteError(timeVarying, stationary, 0.03f * stationary, juce::String(level) + " dB");
+            }
+        }
+
+        beginTest("The full-scale level calibrates the loudness");
+        {
+            ZwickerLoudness reference, calibrated;
+            bands.reset();
+            reference.prepare(bands);
+            runTone(bands, reference, 1000.0, 60.0);
+
+            ZwickerLoudness::Options options;
+            options.fullScaleLevel = 120.0f;
+            bands.reset();
+            calibrated.prepare(bands, options);
+            runTone(bands, calibrated, 1000.0, 40.0);
+
+            expectWithinAbsoluteError(calibrated.getLoudness(), reference.getLoudness(), 0.01f * reference.getLoudness());
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+
+    /** One second of a sine at the given level in dB SPL at the default calibration, 100 dB for an RMS of 1. */
+    static void runTone(OctaveBandAnalyzer& bands, ZwickerLoudness& loudness, double frequency, double level)
+    {
+        const auto amplitude = std::sqrt(2.0) * std::pow(10.0, (level - 100.0) / 20.0);
+        const auto numSamples = static_cast<int>(sampleRate);
+        std::vector<float> block(480);
+
+        for (int start = 0; start < numSamples; start += (int)block.size())
+        {
+            for (size_t i = 0; i < block.size(); ++i)
+                block[i] = static_cast<float>(amplitude * std::sin(juce::MathConstants<double>::twoPi * frequency * static_cast<double>(start + (int)i) / sampleRate));
+
+            bands.process(block.data(), (int)block.size());
+            loudness.process(bands);
+        }
+    }
+};
+
+static ZwickerLoudnessTests zwickerLoudnessTests;
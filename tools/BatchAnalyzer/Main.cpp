@@ -0,0 +1,450 @@
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "MultichannelAnalysisEngine.h"
+#include "SessionExporter.h"
+#include "SessionFile.h"
+#include <iostream>
+#include <set>
+
+//==============================================================================
+// Offline batch analysis: runs audio files through the same MultichannelAnalysisEngine as
+// the plugin, spreading files across a thread pool. Writes one feature file per input
+// (CSV or binary session, with the rows the plugin's export would hold) plus a corpus summary.
+namespace
+{
+    struct Settings
+    {
+        juce::File outputDirectory;
+        double frameRate = AcousticAnalysisEngine::defaultFrameRate;
+        STFTProcessor::Overlap overlap = STFTProcessor::Overlap::half;
+        bool useOverlap = false;
+        bool writeSessionFiles = false;
+        MultichannelAnalysisEngine::Options engine;    // the plugin's defaults unless overridden
+        int numThreads = juce::SystemStats::getNumCpus();
+    };
+
+    struct FileResult
+    {
+        juce::File input;
+        juce::File output;
+        bool succeeded = false;
+        juce::String error;
+        double sampleRate = 0.0;
+        double durationSeconds = 0.0;
+        juce::int64 numFrames = 0;
+
+        // Running sums for the corpus summary
+        double activationScore = 0.0;
+        double spectralCentroid = 0.0;
+        double spectralHarshness = 0.0;
+        double dynamicVariability = 0.0;
+        double temporalUnpredictability = 0.0;
+        double rmsLevel = 0.0;
+
+        // Whole-file loudness
+        float integratedLoudness = LoudnessMeter::minimumLoudness;
+        float loudnessRange = 0.0f;
+
+        // Whole-file sound levels
+        float aWeightedLeq = SoundLevelMeter::minimumLevel;
+        float cWeightedLeq = SoundLevelMeter::minimumLevel;
+        float aWeightedFastMax = SoundLevelMeter::minimumLevel;
+        float aWeightedSlowMax = SoundLevelMeter::minimumLevel;
+        float cWeightedPeak = SoundLevelMeter::minimumLevel;
+
+        // Whole-file time-varying loudness, sone
+        float loudnessN5 = 0.0f;
+        float loudnessN10 = 0.0f;
+        float maxLoudness = 0.0f;
+
+        // Whole-file percentiles of LAF and the activation score: L10, L50, L90, L95
+        std::array<float, SessionStatistics::numPercentiles> levelPercentiles{};
+        std::array<float, SessionStatistics::numPercentiles> scorePercentiles{};
+    };
+
+    constexpr int readBlockSize = 1 << 16;
+
+    void printUsage()
+    {
+        std::cout << "Usage: AcousticAnalyzerBatch [options] <file or directory>...\n\n"
+                     "Analyses WAV, AIFF and FLAC files with the same pipeline as the plugin.\n\n"
+                     "Options:\n"
+                     "  --output=<dir>        Output directory (default: ./acoustic_features)\n"
+                     "  --frame-rate=<hz>     Analysis frames per second (default: 40, as the plugin)\n"
+                     "  --overlap=<percent>   Use a fixed overlap instead: 0, 50, 75 or 87.5\n"
+                     "  --threads=<n>         Number of worker threads (default: all cores)\n"
+                     "  --format=<csv|aas>    Feature file format: CSV or binary session (default: csv)\n"
+                     "  --filterbank=<scale>  Band scale for the cepstrum: mel, bark or erb (default: mel)\n"
+                     "  --bands=<n>           Number of filterbank bands, 8-64 (default: 40)\n"
+                     "  --harshness=<source>  Activation score harshness: spectral or psychoacoustic\n"
+                     "                        (sharpness and roughness) (default: spectral)\n"
+                     "  --calibration=<db>    dB SPL of a full-scale RMS of 1, for loudness, sharpness\n"
+                     "                        and roughness (default: 100)\n"
+                     "  --mid-side            Also analyse mid and side of stereo files, as the plugin can\n"
+                     "  --sum                 Also analyse the average of all channels, as the plugin can\n";
+    }
+
+    bool isSupportedAudioFile(const juce::File& file)
+    {
+        return file.hasFileExtension("wav;aif;aiff;flac");
+    }
+
+    int getHopSize(const Settings& settings, double sampleRate)
+    {
+        return settings.useOverlap
+            ? STFTProcessor::getHopSizeForOverlap(AcousticAnalysisEngine::fftSize, settings.overlap)
+            : STFTProcessor::getHopSizeForFrameRate(AcousticAnalysisEngine::fftSize, sampleRate, settings.frameRate);
+    }
+
+    FileResult analyseFile(const juce::File& input, const juce::File& output, const Settings& settings)
+    {
+        FileResult result;
+        result.input = input;
+        result.output = output;
+
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(input));
+
+        if (reader == nullptr)
+        {
+            result.error = "unsupported or unreadable file";
+            return result;
+        }
+
+        output.deleteFile();
+        juce::FileOutputStream stream(output);
+
+        if (!stream.openedOk())
+        {
+            result.error = "cannot write " + output.getFullPathName();
+            return result;
+        }
+
+        result.sampleRate = reader->sampleRate;
+        result.durationSeconds = static_cast<double>(reader->lengthInSamples) / reader->sampleRate;
+
+        // Every channel and derived stream, with the plugin's engine and options
+        const auto numChannels = juce::jmax(1, static_cast<int>(reader->numChannels));
+        const auto channelLayout = reader->getChannelLayout();
+
+        MultichannelAnalysisEngine engine;
+        engine.setHopSize(getHopSize(settings, reader->sampleRate));
+        engine.prepare(reader->sampleRate, numChannels, settings.engine);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            engine.setLoudnessChannelWeight(ch, LoudnessMeter::getChannelWeight(channelLayout.getTypeOfChannel(ch)));
+
+        std::unique_ptr<SessionFileWriter> sessionWriter;
+
+        if (settings.writeSessionFiles)
+            sessionWriter = std::make_unique<SessionFileWriter>(stream);
+        else
+            stream << SessionExporter::getCSVHeader();
+
+        juce::AudioBuffer<float> buffer(numChannels, readBlockSize);
+        char row[2048];
+
+        for (juce::int64 position = 0; position < reader->lengthInSamples; position += readBlockSize)
+        {
+            const auto numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(readBlockSize),
+                                                                reader->lengthInSamples - position));
+
+            reader->read(&buffer, 0, numSamples, position, true, true);
+
+            engine.process(buffer.getArrayOfReadPointers(), numChannels, numSamples, [&](const AnalysisFrame* frames, int numStreams, const float*)
+                {
+                    // Logged exactly as the plugin logs a session that starts with the file
+                    const auto time = static_cast<double>(frames[0].centreSample) / result.sampleRate;
+
+                    for (int s = 0; s < numStreams; ++s)
+                    {
+                        const auto point = DataPoint::fromFrame(frames[s], s, time);
+
+                        if (sessionWriter != nullptr)
+                            sessionWriter->addPoint(point);
+                        else
+                            stream.write(row, static_cast<size_t>(SessionExporter::formatCSVRow(point, 0.0, row, static_cast<int>(sizeof(row)))));
+                    }
+
+                    // The summary follows the first stream, the plugin's default display
+                    const auto& frame = frames[0];
+                    ++result.numFrames;
+                    result.activationScore += frame.acousticActivationScore;
+                    result.spectralCentroid += frame.spectralCentroid;
+                    result.spectralHarshness += frame.spectralHarshness;
+                    result.dynamicVariability += frame.dynamicVariability;
+                    result.temporalUnpredictability += frame.temporalUnpredictability;
+                    result.rmsLevel += frame.rmsLevel;
+                });
+        }
+
+        if (sessionWriter != nullptr && !sessionWriter->finish())
+        {
+            result.error = "failed to write session file";
+            return result;
+        }
+
+        stream.flush();
+
+        if (stream.getStatus().failed())
+        {
+            result.error = stream.getStatus().getErrorMessage();
+            return result;
+        }
+
+        const auto& loudness = engine.getLoudnessMeter();
+        result.integratedLoudness = loudness.getIntegratedLoudness();
+        result.loudnessRange = loudness.getLoudnessRange();
+
+        const auto& firstStream = engine.getStreamEngine(0);
+        const auto& soundLevels = firstStream.getSoundLevelMeter();
+        const auto sessionPeriod = SoundLevelMeter::numPeriods - 1;
+        result.aWeightedLeq = soundLevels.getEquivalentLevel(SoundLevelMeter::Weighting::a, sessionPeriod);
+        result.cWeightedLeq = soundLevels.getEquivalentLevel(SoundLevelMeter::Weighting::c, sessionPeriod);
+        result.aWeightedFastMax = soundLevels.getMaxTimeWeightedLevel(SoundLevelMeter::Weighting::a, TimeWeighting::Mode::fast);
+        result.aWeightedSlowMax = soundLevels.getMaxTimeWeightedLevel(SoundLevelMeter::Weighting::a, TimeWeighting::Mode::slow);
+        result.cWeightedPeak = soundLevels.getPeakLevel(SoundLevelMeter::Weighting::c);
+
+        const auto& zwickerLoudness = firstStream.getZwickerLoudness();
+        result.loudnessN5 = zwickerLoudness.getPercentileLoudness(5.0f);
+        result.loudnessN10 = zwickerLoudness.getPercentileLoudness(10.0f);
+        result.maxLoudness = zwickerLoudness.getMaxLoudness();
+
+        const auto& statistics = firstStream.getSessionStatistics();
+
+        for (int p = 0; p < SessionStatistics::numPercentiles; ++p)
+        {
+            result.levelPercentiles[(size_t)p] = statistics.getPercentile(SessionStatistics::Feature::level, p);
+            result.scorePercentiles[(size_t)p] = statistics.getPercentile(SessionStatistics::Feature::activationScore, p);
+        }
+
+        result.succeeded = true;
+        return result;
+    }
+
+    bool writeSummary(const juce::File& file, const std::vector<FileResult>& results)
+    {
+        file.deleteFile();
+        juce::FileOutputStream stream(file);
+
+        if (!stream.openedOk())
+            return false;
+
+        stream << "File,Status,Sample_Rate,Duration_Seconds,Frames,Mean_Activation_Score,Mean_Spectral_Centroid,"
+                  "Mean_Spectral_Harshness,Mean_Dynamic_Variability,Mean_Temporal_Unpredictability,Mean_RMS_Level,"
+                  "Integrated_LUFS,Loudness_Range_LU,LAeq,LCeq,LAFmax,LASmax,LCpeak,N5_sone,N10_sone,Nmax_sone";
+
+        for (auto prefix : { ",LA", ",Activation_Score_L" })
+            for (auto percentage : SessionStatistics::percentages)
+                stream << prefix << juce::String(percentage, 0);
+
+        stream << "\n";
+
+        for (const auto& result : results)
+        {
+            const auto frames = static_cast<double>(juce::jmax(static_cast<juce::int64>(1), result.numFrames));
+
+            stream << result.input.getFullPathName().quoted() << ","
+                   << (result.succeeded ? juce::String("ok") : ("failed: " + result.error).quoted()) << ","
+                   << juce::String(result.sampleRate, 0) << ","
+                   << juce::String(result.durationSeconds, 3) << ","
+                   << juce::String(result.numFrames) << ","
+                   << juce::String(result.activationScore / frames, 2) << ","
+                   << juce::String(result.spectralCentroid / frames, 4) << ","
+                   << juce::String(result.spectralHarshness / frames, 4) << ","
+                   << juce::String(result.dynamicVariability / frames, 4) << ","
+                   << juce::String(result.temporalUnpredictability / frames, 4) << ","
+                   << juce::String(result.rmsLevel / frames, 6) << ","
+                   << juce::String(result.integratedLoudness, 2) << ","
+                   << juce::String(result.loudnessRange, 2) << ","
+                   << juce::String(result.aWeightedLeq, 2) << ","
+                   << juce::String(result.cWeightedLeq, 2) << ","
+                   << juce::String(result.aWeightedFastMax, 2) << ","
+                   << juce::String(result.aWeightedSlowMax, 2) << ","
+                   << juce::String(result.cWeightedPeak, 2) << ","
+                   << juce::String(result.loudnessN5, 3) << ","
+                   << juce::String(result.loudnessN10, 3) << ","
+                   << juce::String(result.maxLoudness, 3);
+
+            for (const auto* values : { &result.levelPercentiles, &result.scorePercentiles })
+                for (auto value : *values)
+                    stream << "," << juce::String(value, 2);
+
+            stream << "\n";
+        }
+
+        stream.flush();
+        return !stream.getStatus().failed();
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.size() == 0 || args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return args.size() == 0 ? 1 : 0;
+    }
+
+    Settings settings;
+    settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile("acoustic_features");
+
+    if (args.containsOption("--output"))
+        settings.outputDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+
+    if (args.containsOption("--frame-rate"))
+        settings.frameRate = args.getValueForOption("--frame-rate").getDoubleValue();
+
+    if (args.containsOption("--overlap"))
+    {
+        const auto percent = args.getValueForOption("--overlap").getDoubleValue();
+        settings.useOverlap = true;
+        settings.overlap = percent >= 87.5 ? STFTProcessor::Overlap::sevenEighths
+                         : percent >= 75.0 ? STFTProcessor::Overlap::threeQuarters
+                         : percent >= 50.0 ? STFTProcessor::Overlap::half
+                                           : STFTProcessor::Overlap::none;
+    }
+
+    if (args.containsOption("--format"))
+        settings.writeSessionFiles = args.getValueForOption("--format").equalsIgnoreCase("aas");
+
+    if (args.containsOption("--filterbank"))
+    {
+        const auto scale = args.getValueForOption("--filterbank");
+        settings.engine.filterbank.scale = scale.equalsIgnoreCase("bark") ? PerceptualFilterbank::Scale::bark
+                                  : scale.equalsIgnoreCase("erb")  ? PerceptualFilterbank::Scale::erb
+                                                                   : PerceptualFilterbank::Scale::mel;
+    }
+
+    if (args.containsOption("--bands"))
+        settings.engine.filterbank.numBands = args.getValueForOption("--bands").getIntValue();
+
+    if (args.containsOption("--harshness"))
+        settings.engine.psychoacousticHarshness = args.getValueForOption("--harshness").equalsIgnoreCase("psychoacoustic");
+
+    if (args.containsOption("--calibration"))
+        settings.engine.fullScaleLevel = args.getValueForOption("--calibration").getFloatValue();
+
+    settings.engine.includeMidSide = args.containsOption("--mid-side");
+    settings.engine.includeSum = args.containsOption("--sum");
+
+    if (args.containsOption("--threads"))
+        settings.numThreads = juce::jmax(1, args.getValueForOption("--threads").getIntValue());
+
+    // Collect inputs, expanding directories recursively
+    std::vector<juce::File> inputs;
+
+    for (const auto& arg : args.arguments)
+    {
+        if (arg.isOption())
+            continue;
+
+        const auto file = arg.resolveAsFile();
+
+        if (file.isDirectory())
+        {
+            for (const auto& child : file.findChildFiles(juce::File::findFiles, true))
+                if (isSupportedAudioFile(child))
+                    inputs.push_back(child);
+        }
+        else if (file.existsAsFile())
+        {
+            inputs.push_back(file);
+        }
+        else
+        {
+            std::cerr << "Skipping missing input: " << file.getFullPathName() << "\n";
+        }
+    }
+
+    if (inputs.empty())
+    {
+        std::cerr << "No audio files found.\n";
+        return 1;
+    }
+
+    if (!settings.outputDirectory.createDirectory())
+    {
+        std::cerr << "Cannot create output directory: " << settings.outputDirectory.getFullPathName() << "\n";
+        return 1;
+    }
+
+    // Work out output names up front so files with the same name in different folders don't collide
+    std::vector<juce::File> outputs;
+    std::set<juce::String> usedNames;
+
+    for (const auto& input : inputs)
+    {
+        auto name = input.getFileNameWithoutExtension();
+
+        for (int suffix = 2; usedNames.count(name) > 0; ++suffix)
+            name = input.getFileNameWithoutExtension() + "_" + juce::String(suffix);
+
+        usedNames.insert(name);
+        outputs.push_back(settings.outputDirectory.getChildFile(name + (settings.writeSessionFiles ? ".features.aas" : ".features.csv")));
+    }
+
+    std::vector<FileResult> results(inputs.size());
+    std::atomic<int> numCompleted{ 0 };
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    {
+        juce::ThreadPool pool(settings.numThreads);
+
+        for (size_t i = 0; i < inputs.size(); ++i)
+        {
+            pool.addJob([&, i]
+                {
+                    results[i] = analyseFile(inputs[i], outputs[i], settings);
+                    ++numCompleted;
+                });
+        }
+
+        for (int reported = 0; reported < static_cast<int>(inputs.size());)
+        {
+            juce::Thread::sleep(100);
+
+            if (const auto completed = numCompleted.load(); completed != reported)
+            {
+                reported = completed;
+                std::cout << "\rAnalysed " << reported << " / " << inputs.size() << " files" << std::flush;
+            }
+        }
+
+        std::cout << "\n";
+    }
+
+    const auto elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+    double audioSeconds = 0.0;
+    int numFailed = 0;
+
+    for (const auto& result : results)
+    {
+        if (result.succeeded)
+            audioSeconds += result.durationSeconds;
+        else
+        {
+            ++numFailed;
+            std::cerr << "Failed: " << result.input.getFullPathName() << " (" << result.error << ")\n";
+        }
+    }
+
+    const auto summaryFile = settings.outputDirectory.getChildFile("corpus_summary.csv");
+
+    if (!writeSummary(summaryFile, results))
+    {
+        std::cerr << "Cannot write " << summaryFile.getFullPathName() << "\n";
+        return 1;
+    }
+
+    std::cout << "Analysed " << juce::String(audioSeconds / 3600.0, 2) << " hours of audio in "
+              << juce::String(elapsedSeconds, 1) << " s ("
+              << juce::String(audioSeconds / juce::jmax(elapsedSeconds, 0.001), 0) << "x real time)\n"
+              << "Summary written to " << summaryFile.getFullPathName() << "\n";
+
+    return numFailed == 0 ? 0 : 2;
+}
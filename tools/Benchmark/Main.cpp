@@ -0,0 +1,851 @@
+#include <juce_core/juce_core.h>
+#include "AcousticAnalysisEngine.h"
+#include "AnalysisWorker.h"
+#include "DataLogger.h"
+#include "SessionExporter.h"
+#include <algorithm>
+#include <iostream>
+#include <map>
+
+//==============================================================================
+// Micro-benchmarks for the analysis pipeline and each of its stages. Drives the core
+// with synthetic signals across host block sizes and sample rates, prints the results
+// as JSON and optionally compares them against a stored baseline.
+namespace
+{
+    enum class Signal
+    {
+        silence,
+        pinkNoise,
+        sweep,
+        speechBursts
+    };
+
+    const Signal allSignals[] = { Signal::silence, Signal::pinkNoise, Signal::sweep, Signal::speechBursts };
+
+    struct Settings
+    {
+        std::vector<int> blockSizes{ 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+        std::vector<double> sampleRates{ 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+        double secondsPerRun = 5.0;     // audio per timed run of the pipeline benchmarks
+        int framesPerRun = 2000;        // calls per timed run of the per-frame stage benchmarks
+        int rowsPerExport = 100000;
+        int repetitions = 5;
+        juce::String filter;
+        juce::File output;
+        juce::File baseline;
+        double tolerancePercent = 10.0;
+    };
+
+    struct Result
+    {
+        juce::String benchmark;
+        juce::String signal;
+        double sampleRate = 0.0;
+        int blockSize = 0;
+        juce::int64 calls = 0;
+        double nsPerCall = 0.0;
+        double nsPerSample = 0.0;       // pipeline benchmarks only
+        double realtimeFactor = 0.0;    // seconds of audio analysed per second of CPU
+
+        juce::String getKey() const
+        {
+            return benchmark + "/" + signal + "/" + juce::String(juce::roundToInt(sampleRate)) + "/" + juce::String(blockSize);
+        }
+    };
+
+    // Keeps results alive so the optimiser can't drop the work being timed
+    volatile float sink = 0.0f;
+
+    void printUsage()
+    {
+        std::cout << "Usage: AcousticAnalyzerBenchmark [options]\n\n"
+                     "Times the analysis pipeline and each of its stages with synthetic signals.\n"
+                     "Results are written as JSON; progress goes to stderr.\n\n"
+                     "Options:\n"
+                     "  --output=<file>       Write the JSON results to a file instead of stdout\n"
+                     "  --baseline=<file>     Compare against an earlier --output file\n"
+                     "  --tolerance=<percent> Slowdown reported as a regression (default: 10)\n"
+                     "  --filter=<text>       Only run benchmarks whose name contains this text\n"
+                     "  --repetitions=<n>     Timed runs per benchmark; the median is reported (default: 5)\n"
+                     "  --quick               Fewer block sizes, sample rates and repetitions\n\n"
+                     "Exit code is 2 if any benchmark regressed against the baseline.\n";
+    }
+
+    const char* getSignalName(Signal signal)
+    {
+        switch (signal)
+        {
+            case Signal::silence:      return "silence";
+            case Signal::pinkNoise:    return "pink_noise";
+            case Signal::sweep:        return "sweep";
+            case Signal::speechBursts: return "speech_bursts";
+        }
+
+        return "";
+    }
+
+    //==============================================================================
+    void fillPinkNoise(std::vector<float>& samples, juce::Random& random, float gain)
+    {
+        // Paul Kellet's refined pink filter
+        float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f, b3 = 0.0f, b4 = 0.0f, b5 = 0.0f, b6 = 0.0f;
+
+        for (auto& sample : samples)
+        {
+            const auto white = random.nextFloat() * 2.0f - 1.0f;
+            b0 = 0.99886f * b0 + white * 0.0555179f;
+            b1 = 0.99332f * b1 + white * 0.0750759f;
+            b2 = 0.96900f * b2 + white * 0.1538520f;
+            b3 = 0.86650f * b3 + white * 0.3104856f;
+            b4 = 0.55000f * b4 + white * 0.5329522f;
+            b5 = -0.7616f * b5 - white * 0.0168980f;
+            sample = (b0 + b1 + b2 + b3 + b4 + b5 + b6 + white * 0.5362f) * 0.11f * gain;
+            b6 = white * 0.115926f;
+        }
+    }
+
+    void fillSweep(std::vector<float>& samples, double sampleRate)
+    {
+        // Exponential sine sweep from 20 Hz to just below Nyquist over the whole signal
+        const auto startHz = 20.0;
+        const auto endHz = sampleRate * 0.45;
+        const auto length = static_cast<double>(samples.size());
+        double phase = 0.0;
+
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            const auto frequency = startHz * std::pow(endHz / startHz, static_cast<double>(i) / length);
+            samples[i] = 0.5f * static_cast<float>(std::sin(phase));
+            phase += juce::MathConstants<double>::twoPi * frequency / sampleRate;
+        }
+    }
+
+    void fillSpeechBursts(std::vector<float>& samples, double sampleRate, juce::Random& random)
+    {
+        // Syllable-length voiced bursts with occasional fricatives, separated by short pauses
+        size_t position = 0;
+        double phase = 0.0;
+
+        while (position < samples.size())
+        {
+            const auto burstLength = static_cast<size_t>(sampleRate * (0.12 + 0.15 * random.nextDouble()));
+            const auto pauseLength = static_cast<size_t>(sampleRate * (0.04 + 0.12 * random.nextDouble()));
+            const auto fundamental = 100.0 + 120.0 * random.nextDouble();
+            const auto isFricative = random.nextInt(5) == 0;
+
+            for (size_t i = 0; i < burstLength && position < samples.size(); ++i, ++position)
+            {
+                const auto envelope = 0.5 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * static_cast<double>(i) / static_cast<double>(burstLength));
+                double value = 0.0;
+
+                if (isFricative)
+                {
+                    value = (random.nextDouble() * 2.0 - 1.0) * 0.3;
+                }
+                else
+                {
+                    // Harmonics rolled off at 1/k with a bump around a 700 Hz first formant
+                    for (int k = 1; k <= 24; ++k)
+                    {
+                        const auto harmonicHz = fundamental * k;
+
+                        if (harmonicHz >= sampleRate * 0.5)
+                            break;
+
+                        const auto formant = 1.0 + 2.0 * std::exp(-std::pow((harmonicHz - 700.0) / 300.0, 2.0));
+                        value += formant * std::sin(phase * k) / k;
+                    }
+
+                    value *= 0.15;
+                    phase += juce::MathConstants<double>::twoPi * fundamental / sampleRate;
+                }
+
+                samples[position] = static_cast<float>(value * envelope);
+            }
+
+            for (size_t i = 0; i < pauseLength && position < samples.size(); ++i, ++position)
+                samples[position] = 0.0f;
+        }
+    }
+
+    std::vector<float> generateSignal(Signal signal, double sampleRate, int numSamples)
+    {
+        std::vector<float> samples((size_t)numSamples, 0.0f);
+        juce::Random random(0x5eed);
+
+        switch (signal)
+        {
+            case Signal::silence:      break;
+            case Signal::pinkNoise:    fillPinkNoise(samples, random, 1.0f); break;
+            case Signal::sweep:        fillSweep(samples, sampleRate); break;
+            case Signal::speechBursts: fillSpeechBursts(samples, sampleRate, random); break;
+        }
+
+        return samples;
+    }
+
+    //==============================================================================
+    double getMedian(std::vector<double> values)
+    {
+        std::sort(values.begin(), values.end());
+        return values[values.size() / 2];
+    }
+
+    /**
+        Runs setup and fn once to warm up, then times fn the given number of times and
+        returns the median in seconds. setup runs before every call to fn but isn't timed.
+    */
+    template <typename SetupFn, typename Fn>
+    double measureMedianSeconds(int repetitions, SetupFn&& setup, Fn&& fn)
+    {
+        setup();
+        fn();
+
+        std::vector<double> times;
+
+        for (int i = 0; i < repetitions; ++i)
+        {
+            setup();
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            fn();
+            times.push_back(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start));
+        }
+
+        return getMedian(std::move(times));
+    }
+
+    template <typename Fn>
+    double measureMedianSeconds(int repetitions, Fn&& fn)
+    {
+        return measureMedianSeconds(repetitions, [] {}, std::forward<Fn>(fn));
+    }
+
+    Result makeResult(const juce::String& benchmark, const juce::String& signal, double sampleRate,
+                      int blockSize, juce::int64 calls, double seconds)
+    {
+        Result result;
+        result.benchmark = benchmark;
+        result.signal = signal;
+        result.sampleRate = sampleRate;
+        result.blockSize = blockSize;
+        result.calls = calls;
+        result.nsPerCall = calls > 0 ? seconds * 1.0e9 / static_cast<double>(calls) : 0.0;
+        return result;
+    }
+
+    int getDefaultHopSize(double sampleRate)
+    {
+        return STFTProcessor::getHopSizeForFrameRate(AcousticAnalysisEngine::fftSize, sampleRate,
+                                                     AcousticAnalysisEngine::defaultFrameRate);
+    }
+
+    //==============================================================================
+    class BenchmarkRunner
+    {
+    public:
+        explicit BenchmarkRunner(const Settings& settingsToUse) : settings(settingsToUse) {}
+
+        std::vector<Result> run()
+        {
+            for (auto sampleRate : settings.sampleRates)
+            {
+                for (auto signal : allSignals)
+                {
+                    const auto samples = generateSignal(signal, sampleRate, static_cast<int>(sampleRate * settings.secondsPerRun));
+
+                    for (auto blockSize : settings.blockSizes)
+                    {
+                        runPipeline(samples, signal, sampleRate, blockSize);
+                        runAudioThreadPush(samples, signal, sampleRate, blockSize);
+                        runLoudness(samples, signal, sampleRate, blockSize);
+                        runOctaveBands(samples, signal, sampleRate, blockSize);
+                        runSoundLevels(samples, signal, sampleRate, blockSize);
+                        runZwickerLoudness(samples, signal, sampleRate, blockSize);
+                    }
+
+                    runStages(samples, signal, sampleRate);
+                }
+            }
+
+            runLogging();
+            runExport(SessionExporter::Format::csv, "export_csv", ".csv");
+            runExport(SessionExporter::Format::binarySession, "export_aas", ".aas");
+
+            return results;
+        }
+
+    private:
+        bool isEnabled(const juce::String& benchmark) const
+        {
+            return settings.filter.isEmpty() || benchmark.contains(settings.filter);
+        }
+
+        void addResult(Result result)
+        {
+            std::cerr << result.getKey() << ": " << juce::String(result.nsPerCall, 1) << " ns/call\n";
+            results.push_back(std::move(result));
+        }
+
+        /** What the analysis thread does with one host block: STFT, every feature and the activation score. */
+        void runPipeline(const std::vector<float>& samples, Signal signal, double sampleRate, int blockSize)
+        {
+            if (!isEnabled("pipeline"))
+                return;
+
+            AcousticAnalysisEngine engine;
+            engine.prepare(sampleRate);
+            engine.setHopSize(getDefaultHopSize(sampleRate));
+
+            const auto numSamples = static_cast<int>(samples.size());
+            juce::int64 calls = 0;
+
+            const auto seconds = measureMedianSeconds(settings.repetitions, [&]
+                {
+                    engine.reset();
+                    calls = 0;
+                },
+                [&]
+                {
+                    for (int pos = 0; pos < numSamples; pos += blockSize, ++calls)
+                        engine.process(samples.data() + pos, juce::jmin(blockSize, numSamples - pos),
+                            [](const AnalysisFrame& frame) { sink = sink + frame.acousticActivationScore; });
+                });
+
+            auto result = makeResult("pipeline", getSignalName(signal), sampleRate, blockSize, calls, seconds);
+            result.nsPerSample = seconds * 1.0e9 / numSamples;
+            result.realtimeFactor = seconds > 0.0 ? settings.secondsPerRun / seconds : 0.0;
+            addResult(std::move(result));
+        }
+
+        /** The audio-thread side of processBlock: handing the block to the analysis worker. */
+        void runAudioThreadPush(const std::vector<float>& samples, Signal signal, double sampleRate, int blockSize)
+        {
+            if (!isEnabled("audio_thread_push"))
+                return;
+
+            const auto numSamples = static_cast<int>(samples.size());
+            AnalysisWorker worker([](const float* const* channels, int, int count) { sink = sink + channels[0][count - 1]; });
+            const float* channels[1] = {};
+            juce::int64 calls = 0;
+
+            const auto seconds = measureMedianSeconds(settings.repetitions, [&]
+                {
+                    // Room for the whole signal, so every push takes the copy path rather than the drop path
+                    worker.prepare(1, numSamples + 1);
+                    calls = 0;
+                },
+                [&]
+                {
+                    for (int pos = 0; pos < numSamples; pos += blockSize, ++calls)
+                    {
+                        channels[0] = samples.data() + pos;
+                        worker.push(channels, 1, juce::jmin(blockSize, numSamples - pos));
+                    }
+                });
+
+            worker.release();
+
+            auto result = makeResult("audio_thread_push", getSignalName(signal), sampleRate, blockSize, calls, seconds);
+            result.nsPerSample = seconds * 1.0e9 / numSamples;
+            result.realtimeFactor = seconds > 0.0 ? settings.secondsPerRun / seconds : 0.0;
+            addResult(std::move(result));
+        }
+
+        /** BS.1770 metering of a stereo pair (the signal on both channels), as run for every hop. */
+        void runLoudness(const std::vector<float>& samples, Signal signal, double sampleRate, int blockSize)
+        {
+            if (!isEnabled("loudness"))
+                return;
+
+            const auto numSamples = static_cast<int>(samples.size());
+            LoudnessMeter meter;
+            meter.prepare(sampleRate, 2);
+            const float* channels[2] = {};
+            juce::int64 calls = 0;
+
+            const auto seconds = measureMedianSeconds(settings.repetitions, [&]
+                {
+                    meter.reset();
+                    calls = 0;
+                },
+                [&]
+                {
+                    for (int pos = 0; pos < numSamples; pos += blockSize, ++calls)
+                    {
+                        channels[0] = channels[1] = samples.data() + pos;
+                        meter.process(channels, 2, juce::jmin(blockSize, numSamples - pos));
+                        sink = sink + meter.getShortTermLoudness();
+                    }
+                });
+
+            auto result = makeResult("loudness", getSignalName(signal), sampleRate, blockSize, calls, seconds);
+            result.nsPerSample = seconds * 1.0e9 / numSamples;
+            result.realtimeFactor = seconds > 0.0 ? settings.secondsPerRun / seconds : 0.0;
+            addResult(std::move(result));
+        }
+
+        void runOctaveBands(const std::vector<float>& samples, Signal signal, double sampleRate, int blockSize)
+        {
+            if (!isEnabled("octave_bands"))
+                return;
+
+            const auto numSamples = static_cast<int>(samples.size());
+            OctaveBandAnalyzer analyzer;
+            analyzer.prepare(sampleRate);
+            std::array<float, OctaveBandAnalyzer::numThirdOctaveBands> thirds{};
+            std::array<float, OctaveBandAnalyzer::numOctaveBands> octaves{};
+            juce::int64 calls = 0;
+
+            const auto seconds = measureMedianSeconds(settings.repetitions, [&]
+                {
+                    analyzer.reset();
+                    calls = 0;
+                },
+                [&]
+                {
+                    for (int pos = 0; pos < numSamples; pos += blockSize, ++calls)
+                    {
+                        analyzer.process(samples.data() + pos, juce::jmin(blockSize, numSamples - pos));
+                        analyzer.readLevels(thirds.data(), octaves.data());
+                        sink = sink + octaves[5];
+                    }
+                });
+
+            auto result = makeResult("octave_bands", getSignalName(signal), sampleRate, blockSize, calls, seconds);
+            result.nsPerSample = seconds * 1.0e9 / numSamples;
+            result.realtimeFactor = seconds > 0.0 ? settings.secondsPerRun / seconds : 0.0;
+            addResult(std::move(result));
+        }
+
+        void runSoundLevels(const std::vector<float>& samples, Signal signal, double sampleRate, int blockSize)
+        {
+            if (!isEnabled("sound_level"))
+                return;
+
+            const auto numSamples = static_cast<int>(samples.size());
+            SoundLevelMeter meter;
+            meter.prepare(sampleRate);
+            juce::int64 calls = 0;
+
+            const auto seconds = measureMedianSeconds(settings.repetitions, [&]
+                {
+                    meter.reset();
+                    calls = 0;
+                },
+                [&]
+                {
+                    for (int pos = 0; pos < numSamples; pos += blockSize, ++calls)
+                    {
+                        meter.process(samples.data() + pos, juce::jmin(blockSize, numSamples - pos));
+                        sink = sink + meter.getEquivalentLevel(SoundLevelMeter::Weighting::a, 0);
+                    }
+                });
+
+            auto result = makeResult("sound_level", getSignalName(signal), sampleRate, blockSize, calls, seconds);
+            result.nsPerSample = seconds * 1.0e9 / numSamples;
+            result.realtimeFactor = seconds > 0.0 ? settings.secondsPerRun / seconds : 0.0;
+            addResult(std::move(result));
+        }
+
+        /** Time-varying loudness including the band filters it runs on; subtract octave_bands for the model alone. */
+        void runZwickerLoudness(const std::vector<float>& samples, Signal signal, double sampleRate, int blockSize)
+        {
+            if (!isEnabled("zwicker_loudness"))
+                return;
+
+            const auto numSamples = static_cast<int>(samples.size());
+            OctaveBandAnalyzer analyzer;
+            analyzer.prepare(sampleRate);
+            ZwickerLoudness loudness;
+            loudness.prepare(analyzer);
+            juce::int64 calls = 0;
+
+            const auto seconds = measureMedianSeconds(settings.repetitions, [&]
+                {
+                    analyzer.reset();
+                    loudness.reset();
+                    calls = 0;
+                },
+                [&]
+                {
+                    for (int pos = 0; pos < numSamples; pos += blockSize, ++calls)
+                    {
+                        analyzer.process(samples.data() + pos, juce::jmin(blockSize, numSamples - pos));
+                        loudness.process(analyzer);
+                        sink = sink + loudness.getLoudness();
+                    }
+                });
+
+            auto result = makeResult("zwicker_loudness", getSignalName(signal), sampleRate, blockSize, calls, seconds);
+            result.nsPerSample = seconds * 1.0e9 / numSamples;
+            result.realtimeFactor = seconds > 0.0 ? settings.secondsPerRun / seconds : 0.0;
+            addResult(std::move(result));
+        }
+
+        /** Each per-frame stage in isolation, fed with frames taken from the signal. */
+        void runStages(const std::vector<float>& samples, Signal signal, double sampleRate)
+        {
+            const auto hopSize = getDefaultHopSize(sampleRate);
+            const auto numSamples = static_cast<int>(samples.size());
+            const auto signalName = getSignalName(signal);
+            const auto frames = settings.framesPerRun;
+
+            if (isEnabled("fft"))
+            {
+                STFTProcessor stft(AcousticAnalysisEngine::fftOrder);
+                stft.setHopSize(hopSize);
+
+                // Fill the window up to a hop boundary so that every timed call below completes exactly one frame
+                auto pos = (AcousticAnalysisEngine::fftSize + hopSize - 1) / hopSize * hopSize;
+                stft.process(samples.data(), pos, [](const float*) {});
+
+                const auto seconds = measureMedianSeconds(settings.repetitions, [&]
+                    {
+                        for (int i = 0; i < frames; ++i)
+                        {
+                            if (pos + hopSize > numSamples)
+                                pos = 0;
+
+                            stft.process(samples.data() + pos, hopSize, [](const float* magnitudes) { sink = sink + magnitudes[1]; });
+                            pos += hopSize;
+                        }
+                    });
+
+                addResult(makeResult("fft", signalName, sampleRate, hopSize, frames, seconds));
+            }
+
+            // Collect real spectra and feed the signal through the engine so its RMS history is realistic
+            AcousticAnalysisEngine engine;
+            engine.prepare(sampleRate);
+            engine.setHopSize(hopSize);
+
+            STFTProcessor stft(AcousticAnalysisEngine::fftOrder);
+            stft.setHopSize(hopSize);
+
+            const auto numBins = stft.getNumBins();
+            std::vector<float> spectra;
+
+            stft.process(samples.data(), numSamples, [&](const float* magnitudes)
+                {
+                    spectra.insert(spectra.end(), magnitudes, magnitudes + numBins);
+                });
+
+            engine.process(samples.data(), numSamples, [](const AnalysisFrame&) {});
+
+            const auto numSpectra = static_cast<int>(spectra.size()) / numBins;
+            using Stage = AcousticAnalysisEngine::Stage;
+
+            if (numSpectra > 0 && isEnabled("spectral_features"))
+            {
+                const auto seconds = measureMedianSeconds(settings.repetitions, [&]
+                    {
+                        for (int i = 0; i < frames; ++i)
+                        {
+                            engine.processStage(Stage::spectralFeatures, spectra.data() + (size_t)(i % numSpectra) * (size_t)numBins);
+                            sink = sink + engine.getLatestFrame().spectralEntropy;
+                        }
+                    });
+
+                addResult(makeResult("spectral_features", signalName, sampleRate, hopSize, frames, seconds));
+            }
+
+            if (numSpectra > 0 && isEnabled("filterbank"))
+            {
+                const auto seconds = measureMedianSeconds(settings.repetitions, [&]
+                    {
+                        for (int i = 0; i < frames; ++i)
+                        {
+                            engine.processStage(Stage::perceptualBands, spectra.data() + (size_t)(i % numSpectra) * (size_t)numBins);
+                            sink = sink + engine.getLatestFrame().mfcc[1];
+                        }
+                    });
+
+                addResult(makeResult("filterbank", signalName, sampleRate, hopSize, frames, seconds));
+            }
+
+            if (numSpectra > 0 && isEnabled("tonality"))
+            {
+                const auto seconds = measureMedianSeconds(settings.repetitions, [&]
+                    {
+                        for (int i = 0; i < frames; ++i)
+                        {
+                            engine.processStage(Stage::tonality, spectra.data() + (size_t)(i % numSpectra) * (size_t)numBins);
+                            sink = sink + engine.getLatestFrame().toneToNoiseRatio;
+                        }
+                    });
+
+                addResult(makeResult("tonality", signalName, sampleRate, hopSize, frames, seconds));
+            }
+
+            const auto timeStage = [&](const char* name, Stage stage)
+            {
+                if (!isEnabled(name))
+                    return;
+
+                const auto seconds = measureMedianSeconds(settings.repetitions, [&]
+                    {
+                        for (int i = 0; i < frames; ++i)
+                        {
+                            engine.processStage(stage);
+                            sink = sink + engine.getLatestFrame().acousticActivationScore;
+                        }
+                    });
+
+                addResult(makeResult(name, signalName, sampleRate, hopSize, frames, seconds));
+            };
+
+            timeStage("dynamic_variability", Stage::dynamicVariability);
+            timeStage("temporal_unpredictability", Stage::temporalUnpredictability);
+            timeStage("activation_score", Stage::activationScore);
+        }
+
+        static DataPoint makePoint(int index)
+        {
+            DataPoint point{};
+            point.timestamp = index * 0.025;
+            point.activationScore = static_cast<float>(index % 100);
+            point.spectralCentroid = 0.3f;
+            point.spectralHarshness = 0.2f;
+            point.dynamicVariability = 0.1f;
+            point.temporalUnpredictability = 0.05f;
+            point.rmsLevel = 0.01f * static_cast<float>(index % 50);
+            point.spectralSpread = 1500.0f;
+            point.spectralRolloff = 4000.0f;
+            point.spectralFlatness = 0.4f;
+            point.spectralEntropy = 0.7f;
+            return point;
+        }
+
+        /** DataLogger::push from the analysis thread; the ring is flushed between bursts so nothing is dropped. */
+        void runLogging()
+        {
+            if (!isEnabled("logging"))
+                return;
+
+            DataLogger logger;
+            constexpr int burstSize = 4096;
+            const auto numPoints = settings.rowsPerExport;
+            std::vector<double> times;
+
+            // Only the pushes are timed, not the flushes in between; the first run is a warm-up
+            for (int run = 0; run <= settings.repetitions; ++run)
+            {
+                logger.clear();
+                double seconds = 0.0;
+
+                for (int first = 0; first < numPoints; first += burstSize)
+                {
+                    const auto count = juce::jmin(burstSize, numPoints - first);
+                    const auto start = juce::Time::getHighResolutionTicks();
+
+                    for (int i = 0; i < count; ++i)
+                        logger.push(makePoint(first + i));
+
+                    seconds += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+                    logger.flush();
+                }
+
+                if (run > 0)
+                    times.push_back(seconds);
+            }
+
+            addResult(makeResult("logging", "", 0.0, 0, numPoints, getMedian(std::move(times))));
+        }
+
+        void runExport(SessionExporter::Format format, const char* name, const char* extension)
+        {
+            if (!isEnabled(name))
+                return;
+
+            DataLogger logger;
+
+            for (int first = 0; first < settings.rowsPerExport; first += 4096)
+            {
+                for (int i = first; i < juce::jmin(first + 4096, settings.rowsPerExport); ++i)
+                    logger.push(makePoint(i));
+
+                logger.flush();
+            }
+
+            const auto snapshot = logger.createSnapshot();
+            juce::TemporaryFile destination(extension);
+            SessionExporter exporter;
+
+            const auto seconds = measureMedianSeconds(settings.repetitions, [&]
+                {
+                    exporter.start(snapshot, destination.getFile(), format);
+
+                    while (exporter.isRunning())
+                        juce::Thread::sleep(1);
+                });
+
+            if (exporter.getState() != SessionExporter::State::succeeded)
+            {
+                std::cerr << name << " failed: " << exporter.getErrorMessage() << "\n";
+                return;
+            }
+
+            addResult(makeResult(name, "", 0.0, 0, snapshot.numPoints, seconds));
+        }
+
+        const Settings& settings;
+        std::vector<Result> results;
+    };
+
+    //==============================================================================
+    juce::var toJSON(const Result& result)
+    {
+        auto* object = new juce::DynamicObject();
+        object->setProperty("key", result.getKey());
+        object->setProperty("benchmark", result.benchmark);
+        object->setProperty("signal", result.signal);
+        object->setProperty("sampleRate", result.sampleRate);
+        object->setProperty("blockSize", result.blockSize);
+        object->setProperty("calls", result.calls);
+        object->setProperty("nsPerCall", result.nsPerCall);
+
+        if (result.nsPerSample > 0.0)
+        {
+            object->setProperty("nsPerSample", result.nsPerSample);
+            object->setProperty("realtimeFactor", result.realtimeFactor);
+        }
+
+        return juce::var(object);
+    }
+
+    /** Appends one entry per result that also appears in the baseline and returns the number of regressions. */
+    int compareWithBaseline(const std::vector<Result>& results, const juce::var& baseline,
+                            double tolerancePercent, juce::Array<juce::var>& comparison)
+    {
+        std::map<juce::String, double> baselineTimes;
+
+        if (auto* baselineResults = baseline["results"].getArray())
+            for (const auto& entry : *baselineResults)
+                baselineTimes[entry["key"].toString()] = static_cast<double>(entry["nsPerCall"]);
+
+        int numRegressions = 0;
+
+        for (const auto& result : results)
+        {
+            const auto found = baselineTimes.find(result.getKey());
+
+            if (found == baselineTimes.end() || found->second <= 0.0)
+                continue;
+
+            const auto changePercent = (result.nsPerCall / found->second - 1.0) * 100.0;
+            const auto isRegression = changePercent > tolerancePercent;
+
+            if (isRegression)
+            {
+                ++numRegressions;
+                std::cerr << "REGRESSION " << result.getKey() << ": " << juce::String(found->second, 1)
+                          << " -> " << juce::String(result.nsPerCall, 1) << " ns/call (+"
+                          << juce::String(changePercent, 1) << "%)\n";
+            }
+
+            auto* object = new juce::DynamicObject();
+            object->setProperty("key", result.getKey());
+            object->setProperty("baselineNsPerCall", found->second);
+            object->setProperty("nsPerCall", result.nsPerCall);
+            object->setProperty("changePercent", changePercent);
+            object->setProperty("regression", isRegression);
+            comparison.add(juce::var(object));
+        }
+
+        return numRegressions;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        printUsage();
+        return 0;
+    }
+
+    Settings settings;
+
+    if (args.containsOption("--quick"))
+    {
+        settings.blockSizes = { 64, 512, 4096 };
+        settings.sampleRates = { 48000.0, 192000.0 };
+        settings.secondsPerRun = 2.0;
+        settings.repetitions = 3;
+    }
+
+    if (args.containsOption("--repetitions"))
+        settings.repetitions = juce::jmax(1, args.getValueForOption("--repetitions").getIntValue());
+
+    if (args.containsOption("--filter"))
+        settings.filter = args.getValueForOption("--filter");
+
+    if (args.containsOption("--tolerance"))
+        settings.tolerancePercent = args.getValueForOption("--tolerance").getDoubleValue();
+
+    if (args.containsOption("--output"))
+        settings.output = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+
+    juce::var baseline;
+
+    if (args.containsOption("--baseline"))
+    {
+        settings.baseline = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--baseline"));
+        baseline = juce::JSON::parse(settings.baseline);
+
+        if (!baseline.isObject())
+        {
+            std::cerr << "Cannot read baseline: " << settings.baseline.getFullPathName() << "\n";
+            return 1;
+        }
+    }
+
+    BenchmarkRunner runner(settings);
+    const auto results = runner.run();
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty("formatVersion", 1);
+    report->setProperty("juceVersion", juce::SystemStats::getJUCEVersion());
+    report->setProperty("cpu", juce::SystemStats::getCpuModel());
+    report->setProperty("numCpus", juce::SystemStats::getNumCpus());
+    report->setProperty("os", juce::SystemStats::getOperatingSystemName());
+    report->setProperty("time", juce::Time::getCurrentTime().toISO8601(true));
+
+    juce::Array<juce::var> resultArray;
+
+    for (const auto& result : results)
+        resultArray.add(toJSON(result));
+
+    report->setProperty("results", resultArray);
+
+    int numRegressions = 0;
+
+    if (baseline.isObject())
+    {
+        juce::Array<juce::var> comparison;
+        numRegressions = compareWithBaseline(results, baseline, settings.tolerancePercent, comparison);
+        report->setProperty("baseline", settings.baseline.getFullPathName());
+        report->setProperty("tolerancePercent", settings.tolerancePercent);
+        report->setProperty("comparison", comparison);
+        report->setProperty("numRegressions", numRegressions);
+    }
+
+    const auto json = juce::JSON::toString(juce::var(report));
+
+    if (settings.output == juce::File())
+    {
+        std::cout << json << "\n";
+    }
+    else if (!settings.output.replaceWithText(json))
+    {
+        std::cerr << "Cannot write " << settings.output.getFullPathName() << "\n";
+        return 1;
+    }
+
+    return numRegressions == 0 ? 0 : 2;
+}